@@ -0,0 +1,30 @@
+#ifndef GRAPHICS_BENCHCONTEXT_H
+#define GRAPHICS_BENCHCONTEXT_H
+
+#include <memory>
+
+#include "../src/framework/shaderManager.h"
+#include "../src/framework/streamBuffer.h"
+#include "../src/font/fontRenderer.h"
+
+/// @brief The GL context and engine objects the benchmarks share
+/// @details Created once by main() before any benchmark runs; shapes need a linked program to resolve their
+/// uniforms, and text layout needs the font atlas.
+struct BenchContext {
+    std::unique_ptr<StreamBuffer> streamBuffer;
+    std::unique_ptr<ShaderManager> shaderManager;
+    Shader shapeShader;
+    std::unique_ptr<FontRenderer> fontRenderer;
+};
+
+/// @brief Returns the shared objects; only valid between initBenchContext() and destroyBenchContext()
+BenchContext &benchContext();
+
+/// @brief Creates an offscreen GL context (EGL when available, else a hidden GLFW window) and the shared objects
+/// @return false if no context could be created or the resources were not found
+bool initBenchContext();
+
+/// @brief Releases the shared objects and the context
+void destroyBenchContext();
+
+#endif //GRAPHICS_BENCHCONTEXT_H
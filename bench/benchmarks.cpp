@@ -0,0 +1,218 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "benchContext.h"
+#include "../src/levels.h"
+#include "../src/font/textLayout.h"
+#include "../src/framework/glRenderer.h"
+#include "../src/framework/particleSystem.h"
+#include "../src/shapes/circle.h"
+#include "../src/shapes/rect.h"
+
+using std::vector, std::unique_ptr, std::make_unique;
+
+namespace {
+    /// @brief The ball and paddle as the game creates them, with the ball resting on the paddle or far above it
+    struct BallAndPaddle {
+        Rect paddle;
+        Circle ball;
+
+        explicit BallAndPaddle(bool touching)
+            : paddle(benchContext().shapeShader, vec2{500, 200}, vec2{200, 15}, color{1, 0, 0, 1}),
+              ball(benchContext().shapeShader, vec2{500, touching ? 209 : 600}, 2.25, color{1, 1, 1, 1}) {}
+    };
+
+    vector<unique_ptr<Shape>> makeBricks(void (*build)(vector<BrickSpec> &)) {
+        vector<BrickSpec> specs;
+        build(specs);
+        vector<unique_ptr<Shape>> bricks;
+        for (const BrickSpec &brick : specs) {
+            bricks.push_back(make_unique<Rect>(benchContext().shapeShader, brick.pos, brick.size, brick.fill));
+        }
+        return bricks;
+    }
+}
+
+// ------------------------------------------------------------------------
+// Collision
+// ------------------------------------------------------------------------
+
+static void BM_CircleIsOverlappingPaddle(benchmark::State &state) {
+    BallAndPaddle shapes(state.range(0) != 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Circle::isOverlappingPaddle(shapes.ball, shapes.paddle));
+    }
+}
+BENCHMARK(BM_CircleIsOverlappingPaddle)->ArgName("touching")->Arg(0)->Arg(1);
+
+static void BM_RectIsOverlapping(benchmark::State &state) {
+    Shader &shader = benchContext().shapeShader;
+    Rect a(shader, vec2{100, 100}, vec2{85, 40}, color{1, 0, 0, 1});
+    Rect b(shader, vec2{state.range(0) ? 150 : 400, 100}, vec2{85, 40}, color{0, 1, 0, 1});
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Rect::isOverlapping(a, b));
+    }
+}
+BENCHMARK(BM_RectIsOverlapping)->ArgName("touching")->Arg(0)->Arg(1);
+
+// Through the virtual Shape overload, which pays for a dynamic_cast
+static void BM_RectIsOverlappingShape(benchmark::State &state) {
+    Shader &shader = benchContext().shapeShader;
+    Rect a(shader, vec2{100, 100}, vec2{85, 40}, color{1, 0, 0, 1});
+    Rect b(shader, vec2{150, 100}, vec2{85, 40}, color{0, 1, 0, 1});
+    const Shape &other = b;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.isOverlapping(other));
+    }
+}
+BENCHMARK(BM_RectIsOverlappingShape);
+
+// One update() worth of brick tests on the fullest level
+static void BM_BrickScan(benchmark::State &state) {
+    vector<unique_ptr<Shape>> bricks = makeBricks(buildHardLevel);
+    BallAndPaddle shapes(false);
+    for (auto _ : state) {
+        int hits = 0;
+        for (const unique_ptr<Shape> &brick : bricks) {
+            hits += Circle::isOverlappingPaddle(shapes.ball, *brick);
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * bricks.size());
+}
+BENCHMARK(BM_BrickScan);
+
+// ------------------------------------------------------------------------
+// Drawing
+// ------------------------------------------------------------------------
+
+static void BM_ShapeModelMatrix(benchmark::State &state) {
+    BallAndPaddle shapes(false);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shapes.paddle.getModelMatrix());
+    }
+}
+BENCHMARK(BM_ShapeModelMatrix);
+
+// The model matrix plus the glUniform calls of Shape::setUniforms()
+static void BM_ShapeSetUniforms(benchmark::State &state) {
+    BallAndPaddle shapes(false);
+    benchContext().shapeShader.use();
+    for (auto _ : state) {
+        shapes.paddle.setUniforms();
+    }
+}
+BENCHMARK(BM_ShapeSetUniforms);
+
+// One frame of the particle kernel with the whole budget alive
+static void BM_ParticleUpdate(benchmark::State &state) {
+    const int count = static_cast<int>(state.range(0));
+    ParticleSystem particles(count);
+    for (auto _ : state) {
+        if (particles.size() < static_cast<size_t>(count) / 2) {
+            // refill once enough have died, outside the timing
+            state.PauseTiming();
+            particles.clear();
+            particles.emitBurst(vec2{500, 400}, vec2{85, 40}, vec4{0, 0.5f, 0.7f, 1}, vec2{0, 300}, count);
+            state.ResumeTiming();
+        }
+        particles.update(1.0f / 60.0f);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ParticleUpdate)->ArgName("particles")->Arg(1000)->Arg(100000);
+
+// ------------------------------------------------------------------------
+// Rendering
+// ------------------------------------------------------------------------
+
+// A frame of instanced circles, more than one segment of the instance stream holds. Only the last circle is green
+// and it covers the middle of the framebuffer, so the run fails if the end of the batch is not drawn.
+static void BM_DrawCircles(benchmark::State &state) {
+    BenchContext &context = benchContext();
+    GLRenderer renderer(*context.shaderManager, *context.fontRenderer);
+    const int count = static_cast<int>(state.range(0));
+    FrameUniforms frame{};
+    frame.projection = glm::ortho(0.0f, 64.0f, 0.0f, 64.0f, -1.0f, 1.0f);
+    frame.viewport = vec4(0, 0, 64, 64);
+    glViewport(0, 0, 64, 64);
+    for (auto _ : state) {
+        context.streamBuffer->beginFrame();
+        context.shaderManager->updateFrameUniforms(frame, *context.streamBuffer);
+        renderer.clear(vec4(0, 0, 0, 1));
+        for (int i = 0; i + 1 < count; ++i) {
+            renderer.submitCircle(vec2(i % 64, i / 64 % 64), 2, vec4(1, 0, 0, 1), RenderLayer::Actors);
+        }
+        renderer.submitCircle(vec2(32, 32), 8, vec4(0, 1, 0, 1), RenderLayer::Actors);
+        renderer.flush();
+        context.streamBuffer->endFrame();
+        glFinish();
+    }
+
+    unsigned char pixel[4] = {};
+    glReadPixels(32, 32, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    if (pixel[0] != 0 || pixel[1] != 255) {
+        state.SkipWithError("the end of the batch was not drawn");
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_DrawCircles)->ArgName("circles")->Arg(20000)->Arg(100000);
+
+// ------------------------------------------------------------------------
+// Text
+// ------------------------------------------------------------------------
+
+static void BM_FontLayout(benchmark::State &state) {
+    const std::string_view text = "Arrow keys (Left, Right) to move!";
+    vector<GlyphVertex> vertices;
+    for (auto _ : state) {
+        vertices.clear();
+        benchContext().fontRenderer->layout(text.data(), text.size(), 100, 100, 0.75f, vec3(1, 0, 0), vertices);
+        benchmark::DoNotOptimize(vertices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_FontLayout);
+
+// A changed line: layout of the whole block plus the upload
+static void BM_TextLayoutUpdate(benchmark::State &state) {
+    TextLayout layout(*benchContext().fontRenderer);
+    layout.addLine("Choose a difficulty:", 500, 600, 1.2f, vec3(1), TextAlign::Center);
+    size_t counter = layout.addLine("Death Counts: 0", 10, 20, 0.5f, vec3(1));
+    layout.addLine("Press space to start", 500, 400, 1, vec3(1), TextAlign::Center);
+    bool flip = false;
+    for (auto _ : state) {
+        layout.setText(counter, flip ? "Death Counts: 1" : "Death Counts: 2");
+        layout.update();
+        flip = !flip;
+    }
+}
+BENCHMARK(BM_TextLayoutUpdate);
+
+// ------------------------------------------------------------------------
+// Level construction
+// ------------------------------------------------------------------------
+
+// Brick positions and colors only
+static void BM_BuildLevel(benchmark::State &state) {
+    void (*const builders[])(vector<BrickSpec> &) = {buildEasyLevel, buildNormalLevel, buildHardLevel,
+                                                    [](vector<BrickSpec> &bricks) { buildRandomLevel(bricks, 1); }};
+    vector<BrickSpec> specs;
+    for (auto _ : state) {
+        specs.clear();
+        builders[state.range(0)](specs);
+        benchmark::DoNotOptimize(specs.data());
+    }
+}
+BENCHMARK(BM_BuildLevel)->ArgName("level")->DenseRange(0, 3);
+
+// What Engine::initShapes() does per level: the specs plus a heap allocated Rect per brick
+static void BM_BuildLevelShapes(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(makeBricks(buildHardLevel));
+    }
+}
+BENCHMARK(BM_BuildLevelShapes);
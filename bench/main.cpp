@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+
+#include "benchContext.h"
+#include "../src/framework/meshManager.h"
+#ifdef HAS_EGL
+#include "../src/framework/headlessContext.h"
+#endif
+
+namespace {
+    BenchContext context;
+#ifdef HAS_EGL
+    std::unique_ptr<HeadlessContext> headlessContext;
+#else
+    GLFWwindow *window = nullptr;
+#endif
+}
+
+BenchContext &benchContext() {
+    return context;
+}
+
+bool initBenchContext() {
+#ifdef HAS_EGL
+    headlessContext = std::make_unique<HeadlessContext>();
+    if (!headlessContext->init(64, 64))
+        return false;
+#else
+    // No EGL: a hidden window is the next best thing
+    if (!glfwInit())
+        return false;
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    window = glfwCreateWindow(64, 64, "breakout_bench", nullptr, nullptr);
+    if (!window)
+        return false;
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+        return false;
+#endif
+
+    // The same resources the game loads
+    context.streamBuffer = std::make_unique<StreamBuffer>(1 << 20);
+    context.shaderManager = std::make_unique<ShaderManager>();
+    context.shapeShader = context.shaderManager->loadShader("shaders/shape.vert", "shaders/shape.frag",
+                                                            nullptr, "shape");
+    context.shaderManager->loadShader("shaders/text.vert", "shaders/textSdf.frag", nullptr, "text");
+    context.shaderManager->loadShader("shaders/sprite.vert", "shaders/sprite.frag", nullptr, "sprite");
+    context.shaderManager->loadShader("shaders/circle.vert", "shaders/circle.frag", nullptr, "circle");
+    context.shaderManager->loadShader("shaders/particle.vert", "shaders/particle.frag", nullptr, "particle");
+    context.fontRenderer = std::make_unique<FontRenderer>(context.shaderManager->getShader("text"),
+                                                          *context.streamBuffer, "fonts/MxPlus_IBM_BIOS.ttf", 24, FontMode::SDF);
+    return context.shapeShader.ID != 0;
+}
+
+void destroyBenchContext() {
+    context.fontRenderer.reset();
+    context.shaderManager.reset();
+    context.streamBuffer.reset();
+    MeshManager::clear();
+#ifdef HAS_EGL
+    headlessContext.reset();
+#else
+    glfwTerminate();
+#endif
+}
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    if (!initBenchContext()) {
+        std::cout << "ERROR::BENCH: Failed to create an OpenGL context or load the resources" << std::endl;
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    destroyBenchContext();
+    return 0;
+}
@@ -0,0 +1,20 @@
+# Renders the menu with the software renderer, which needs no GPU or GL context, and compares the frame with a
+# golden PNG per channel (see tests/compareImages.cpp), with a small tolerance for rounding differences between
+# compilers and CPUs.
+# Usage: cmake -DGAME=<executable> -DCOMPARE=<breakout_compare> -DGOLDEN=<png> -DWORK_DIR=<dir> -P compareFrame.cmake
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+execute_process(COMMAND ${GAME} --headless --software --frames 1 --capture ${WORK_DIR}
+                WORKING_DIRECTORY ${WORK_DIR}
+                RESULT_VARIABLE RESULT)
+if(NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "${GAME} failed: ${RESULT}")
+endif()
+
+set(FRAME ${WORK_DIR}/frame_00000.png)
+execute_process(COMMAND ${COMPARE} ${FRAME} ${GOLDEN} RESULT_VARIABLE DIFFERENT)
+if(NOT DIFFERENT EQUAL 0)
+    # an intended change to the menu or the rasterizer: look at the new frame and copy it over the golden one
+    message(FATAL_ERROR "${FRAME} differs from ${GOLDEN}")
+endif()
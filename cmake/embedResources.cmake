@@ -0,0 +1,31 @@
+# Generates a source file holding every file under res/shaders and res/fonts as a constexpr byte array,
+# registered by its path relative to res/ (see src/framework/resources.h).
+# Usage: cmake -DRESOURCE_DIR=<res> -DOUTPUT=<file.cpp> -P embedResources.cmake
+
+file(GLOB RESOURCE_FILES RELATIVE ${RESOURCE_DIR} ${RESOURCE_DIR}/shaders/* ${RESOURCE_DIR}/fonts/*)
+list(SORT RESOURCE_FILES)
+
+set(ARRAYS "")
+set(ENTRIES "")
+set(INDEX 0)
+foreach(RESOURCE ${RESOURCE_FILES})
+    file(READ ${RESOURCE_DIR}/${RESOURCE} HEX_CONTENT HEX)
+    # 16 bytes per line, then every byte as 0xNN
+    string(REGEX REPLACE "([0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f][0-9a-f])"
+           "\\1\n        " HEX_CONTENT "${HEX_CONTENT}")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," HEX_CONTENT "${HEX_CONTENT}")
+    # the terminating zero lets text resources be used as C strings; it is not counted in the size
+    string(APPEND ARRAYS "    // ${RESOURCE}\n    constexpr unsigned char resource${INDEX}[] = {\n        ${HEX_CONTENT}0x00};\n\n")
+    string(APPEND ENTRIES "    {\"${RESOURCE}\", resource${INDEX}, sizeof(resource${INDEX}) - 1},\n")
+    math(EXPR INDEX "${INDEX} + 1")
+endforeach()
+
+set(CONTENT "// Generated by cmake/embedResources.cmake from ${RESOURCE_DIR}; do not edit\n\n")
+string(APPEND CONTENT "#include \"framework/resources.h\"\n\nnamespace {\n${ARRAYS}}\n\n")
+string(APPEND CONTENT "const EmbeddedResource embeddedResources[] = {\n${ENTRIES}};\n\n")
+string(APPEND CONTENT "const size_t embeddedResourceCount = ${INDEX};\n")
+
+# only touch the output when it changed, so saving a resource unchanged does not recompile it
+file(WRITE ${OUTPUT}.tmp "${CONTENT}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different ${OUTPUT}.tmp ${OUTPUT})
+file(REMOVE ${OUTPUT}.tmp)
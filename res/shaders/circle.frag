@@ -1,18 +1,24 @@
 #version 330 core
 
 out vec4 FragColor;
-in vec2 FragPos;
 
-uniform vec4 shapeColor;
-uniform float radius;
-uniform vec2 center;
+in vec2 Local;
+flat in vec2 HalfSize;
+flat in float Radius;
+flat in vec4 Color;
 
 void main()
 {
-    // Calculate the distance from the center to the fragment
-    if (length(FragPos - center) > radius) {
-        // Discard all fragments outside the circle
+    // Signed distance from the fragment to the edge of a rounded box, negative inside.
+    // A circle is a box whose corner radius is half its size.
+    vec2 q = abs(Local) - HalfSize + Radius;
+    float dist = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - Radius;
+
+    // antialias over one screen pixel
+    float alpha = clamp(0.5 - dist / max(fwidth(dist), 1e-4), 0.0, 1.0);
+    if (alpha <= 0.0) {
+        // Discard all fragments outside the shape
         discard;
     }
-    FragColor = shapeColor;
+    FragColor = vec4(Color.rgb, Color.a * alpha);
 }
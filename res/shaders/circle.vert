@@ -1,15 +1,27 @@
 #version 330 core
 
-layout (location = 0) in vec2 aPos;
+layout (location = 0) in vec2 aPos;            // corner of the unit quad, -0.5 to 0.5
+layout (location = 1) in vec4 instanceBox;     // center (xy) and half size (zw) in pixels
+layout (location = 2) in vec4 instanceColor;
+layout (location = 3) in float instanceRadius; // corner radius in pixels
 
-uniform mat4 model;
-uniform mat4 projection;
+layout (std140) uniform FrameData {
+    mat4 projection;
+    vec4 viewport; // x, y, width, height in pixels
+    float time;    // seconds since start
+};
 
-out vec2 FragPos;
+out vec2 Local;
+flat out vec2 HalfSize;
+flat out float Radius;
+flat out vec4 Color;
 
 void main()
 {
-    vec4 worldPos = model * vec4(aPos.x, aPos.y, 0.0, 1.0);
-    FragPos = worldPos.xy;
-    gl_Position = projection * worldPos;
+    // grow the quad by a pixel so the antialiased edge is not clipped
+    Local = aPos * 2.0 * (instanceBox.zw + 1.0);
+    HalfSize = instanceBox.zw;
+    Radius = instanceRadius;
+    Color = instanceColor;
+    gl_Position = projection * vec4(instanceBox.xy + Local, 0.0, 1.0);
 }
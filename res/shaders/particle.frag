@@ -0,0 +1,18 @@
+#version 330 core
+
+out vec4 FragColor;
+
+in vec2 Local;
+flat in float Radius;
+flat in vec4 Color;
+
+void main()
+{
+    // Signed distance to the edge of the dot, antialiased over one screen pixel
+    float dist = length(Local) - Radius;
+    float alpha = clamp(0.5 - dist / max(fwidth(dist), 1e-4), 0.0, 1.0);
+    if (alpha <= 0.0) {
+        discard;
+    }
+    FragColor = vec4(Color.rgb, Color.a * alpha);
+}
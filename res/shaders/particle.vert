@@ -0,0 +1,29 @@
+#version 330 core
+
+layout (location = 0) in vec2 aPos;            // corner of the unit quad, -0.5 to 0.5
+layout (location = 1) in float particleX;      // position in pixels
+layout (location = 2) in float particleY;
+layout (location = 3) in float particleLife;   // 1 when spawned, 0 when gone
+layout (location = 4) in vec4 particleColor;
+
+uniform float particleSize; // diameter in pixels when spawned
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    vec4 viewport; // x, y, width, height in pixels
+    float time;    // seconds since start
+};
+
+out vec2 Local;
+flat out float Radius;
+flat out vec4 Color;
+
+void main()
+{
+    // particles shrink and fade out over their life
+    Radius = 0.5 * particleSize * particleLife;
+    // grow the quad by a pixel so the antialiased edge is not clipped
+    Local = aPos * 2.0 * (Radius + 1.0);
+    Color = vec4(particleColor.rgb, particleColor.a * particleLife);
+    gl_Position = projection * vec4(vec2(particleX, particleY) + Local, 0.0, 1.0);
+}
@@ -3,7 +3,12 @@
 layout (location = 0) in vec2 aPos;
 
 uniform mat4 model;
-uniform mat4 projection;
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    vec4 viewport; // x, y, width, height in pixels
+    float time;    // seconds since start
+};
 
 void main()
 {
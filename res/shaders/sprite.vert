@@ -1,14 +1,20 @@
 #version 330 core
-// Both position and texture coordinates contain two floats, so we combine them into a single vertex attribute
-layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+// Drawn with the shared unit quad mesh (-0.5 to 0.5); texture coordinates are derived from the position
+layout (location = 0) in vec2 aPos;
 
 out vec2 TexCoords;
 
 uniform mat4 model;
-uniform mat4 projection;
+
+layout (std140) uniform FrameData {
+    mat4 projection;
+    vec4 viewport; // x, y, width, height in pixels
+    float time;    // seconds since start
+};
 
 void main()
 {
-    TexCoords = vertex.zw;
-    gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
-}
\ No newline at end of file
+    // Flip y so the top left of the image maps to the top left of the quad
+    TexCoords = vec2(aPos.x + 0.5, 0.5 - aPos.y);
+    gl_Position = projection * model * vec4(aPos, 0.0, 1.0);
+}
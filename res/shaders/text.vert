@@ -1,11 +1,21 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+layout (location = 1) in vec4 color;  // text color of the glyph
+layout (location = 2) in float page;  // atlas page (texture array layer) of the glyph
 out vec2 TexCoords;
+out vec4 TextColor;
+flat out float Page;
 
-uniform mat4 projection;
+layout (std140) uniform FrameData {
+    mat4 projection;
+    vec4 viewport; // x, y, width, height in pixels
+    float time;    // seconds since start
+};
 
 void main()
 {
     gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
     TexCoords = vertex.zw;
-}  
\ No newline at end of file
+    TextColor = color;
+    Page = page;
+}
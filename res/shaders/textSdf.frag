@@ -0,0 +1,40 @@
+#version 330 core
+in vec2 TexCoords;
+in vec4 TextColor;
+flat in float Page;
+out vec4 color;
+
+uniform sampler2DArray text;
+
+// Effect widths are in distance field units (the glyph edge is at 0.5); 0 disables the effect
+uniform float outlineWidth;
+uniform vec4 outlineColor;
+uniform float glowWidth;
+uniform vec4 glowColor;
+
+// Composites a non-premultiplied color over another
+vec4 over(vec4 top, vec4 bottom)
+{
+    float a = top.a + bottom.a * (1.0 - top.a);
+    if (a <= 0.0)
+        return vec4(0.0);
+    return vec4((top.rgb * top.a + bottom.rgb * bottom.a * (1.0 - top.a)) / a, a);
+}
+
+void main()
+{
+    // the atlas stores a signed distance in the red channel, 0.5 on the glyph edge
+    float dist = texture(text, vec3(TexCoords, Page)).r;
+    // antialias over about one screen pixel whatever the text scale
+    float smoothing = 0.7 * fwidth(dist);
+
+    float fill = smoothstep(0.5 - smoothing, 0.5 + smoothing, dist);
+    float outlineEdge = 0.5 - outlineWidth;
+    float outline = smoothstep(outlineEdge - smoothing, outlineEdge + smoothing, dist);
+    float glow = glowWidth > 0.0 ? smoothstep(0.5 - glowWidth, 0.5, dist) : 0.0;
+
+    vec4 result = vec4(TextColor.rgb, TextColor.a * fill);
+    result = over(result, vec4(outlineColor.rgb, outlineColor.a * outline));
+    result = over(result, vec4(glowColor.rgb, glowColor.a * glow));
+    color = result;
+}
@@ -1,5 +1,15 @@
 #include "engine.h"
 
+#include <chrono>
+#include <filesystem>
+
+#include "levels.h"
+#include "framework/pngWriter.h"
+#include "util/fixedString.h"
+#include "framework/allocationTracker.h"
+#include "framework/profiler.h"
+#include "framework/resources.h"
+
 enum state {start, easy, normal, hard, random_, win, lose};
 state screen;
 
@@ -8,17 +18,78 @@ color originalFill;
 
 int deathCounter = 0;
 
-Engine::Engine() : keys() {
-    this->initWindow();
-    this->initShaders();
-    this->initShapes();
+// Particles: the most alive at once, and the debris of one broken brick
+const size_t maxParticles = 100000;
+const int particlesPerBrick = 400;
+
+Engine::Engine(const EngineConfig &config) : config(config), keys() {
+    Resources::setOverrideDirectory(config.resourceDirectory);
+
+    // Work that needs no GL context runs on worker threads while the context is created: the font atlas
+    // (read from the cache, or rasterized by FreeType) and the brick layouts. This thread then only uploads.
+    srand(config.benchmarkReport.empty() ? static_cast<unsigned int>(time(NULL)) : EngineConfig::benchmarkSeed);
+    const unsigned int seed = levelSeed();
+    std::future<unique_ptr<Font>> font = std::async(std::launch::async, [] {
+        Profiler::setThreadName("startup font");
+        return make_unique<Font>("fonts/MxPlus_IBM_BIOS.ttf", 24, FontMode::SDF);
+    });
+    std::future<LevelSpecs> levels = std::async(std::launch::async, [seed] {
+        Profiler::setThreadName("startup levels");
+        PROFILE_ZONE("buildLevels");
+        return buildLevels(seed);
+    });
+
+    if (this->initWindow() != 0) {
+        // Nothing can be drawn without a context
+        cout << "ERROR::ENGINE: Failed to create an OpenGL context" << endl;
+        font.wait();
+        levels.wait();
+        std::exit(EXIT_FAILURE);
+    }
+    this->initShaders(font);
+    this->initShapes(levels.get());
+    this->initText();
+    particles = make_unique<ParticleSystem>(maxParticles);
+    renderer->reserveParticles(particles->capacity());
+    // Timing the GPU flushes at every layer, so it is only done when a trace is asked for (or F3 is pressed)
+    renderer->setGpuTiming(!config.traceFile.empty());
+
+    if (!config.recordTarget.empty()) {
+        // frames the renderer draws on the CPU are recorded from there, without reading them back
+        recorder = make_unique<FrameRecorder>(width, height, config.recordFormat, config.recordTarget,
+                                              renderer->getPixels() == nullptr);
+    }
+    if (!config.benchmarkReport.empty()) {
+        session = make_unique<ScriptedSession>();
+    }
 
     originalFill = {1, 0, 0, 1};
 }
 
-Engine::~Engine() {}
+Engine::~Engine() {
+    // Write out the frames still being read back
+    recorder.reset();
+    // Shared meshes must be deleted while the context is still alive
+    MeshManager::clear();
+}
 
 unsigned int Engine::initWindow(bool debug) {
+    if (config.headless) {
+        // The software renderer keeps the frame in memory, so nothing needs a context
+        if (!config.needsContext()) {
+            return 0;
+        }
+        // Offscreen: an EGL context rendering into a framebuffer object, no GLFW at all
+        headlessContext = make_unique<HeadlessContext>();
+        if (!headlessContext->init(width, height)) {
+            return -1;
+        }
+        glViewport(0, 0, width, height);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        return 0;
+    }
+
     // glfw: initialize and configure
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -44,171 +115,197 @@ unsigned int Engine::initWindow(bool debug) {
     glViewport(0, 0, width, height);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glfwSwapInterval(1);
+    // Benchmarks run uncapped, so frame times are not rounded up to the refresh rate
+    glfwSwapInterval(config.benchmarkReport.empty() ? 1 : 0);
 
     return 0;
 }
 
-void Engine::initShaders() {
+void Engine::initShaders(std::future<unique_ptr<Font>> &font) {
+    PROFILE_ZONE("Engine::initShaders");
+    if (!config.needsContext()) {
+        // No programs, stream buffer or atlas texture: text is only laid out, for the software renderer
+        fontRenderer = make_unique<FontRenderer>(font.get());
+        renderer = make_unique<SoftwareRenderer>(*fontRenderer, width, height);
+        return;
+    }
+
+    // Frame uniforms and text are streamed through one ring buffer; 1 MB per frame in flight
+    streamBuffer = make_unique<StreamBuffer>(1 << 20);
+
     // Load shader manager
     shaderManager = make_unique<ShaderManager>();
 
     // Load shader into shader manager and retrieve it
-    shapeShader = this->shaderManager->loadShader("../res/shaders/shape.vert", "../res/shaders/shape.frag",  nullptr, "shape");
-
-    // Configure text shader and renderer
-    textShader = shaderManager->loadShader("../res/shaders/text.vert", "../res/shaders/text.frag", nullptr, "text");
-    fontRenderer = make_unique<FontRenderer>(shaderManager->getShader("text"), "../res/fonts/MxPlus_IBM_BIOS.ttf", 24);
+    shapeShader = this->shaderManager->loadShader("shaders/shape.vert", "shaders/shape.frag",  nullptr, "shape");
+
+    // Configure text shader
+    // Glyphs are stored as a distance field, so every text scale is drawn sharp from one atlas
+    textShader = shaderManager->loadShader("shaders/text.vert", "shaders/textSdf.frag", nullptr, "text");
+
+    // Sprites are drawn by the renderer, which replays every draw submitted during the frame
+    shaderManager->loadShader("shaders/sprite.vert", "shaders/sprite.frag", nullptr, "sprite");
+    // Circles are drawn as instanced quads with an analytic edge
+    shaderManager->loadShader("shaders/circle.vert", "shaders/circle.frag", nullptr, "circle");
+    // Particles are drawn instanced straight from the particle system's arrays
+    shaderManager->loadShader("shaders/particle.vert", "shaders/particle.frag", nullptr, "particle");
+
+    // Every program is built, so only now wait for the font and upload its atlas
+    fontRenderer = make_unique<FontRenderer>(shaderManager->getShader("text"), *streamBuffer, font.get());
+    if (config.software) {
+        renderer = make_unique<SoftwareRenderer>(*shaderManager, *fontRenderer, width, height);
+    } else {
+        renderer = make_unique<GLRenderer>(*shaderManager, *fontRenderer);
+    }
 
     // Set uniforms
+    // The projection is shared by every program through the FrameData block, see render()
     textShader.setVector2f("vertex", vec4(100, 100, .5, .5));
-    shapeShader.use();
-    shapeShader.setMatrix4("projection", this->PROJECTION);
+}
+
+void Engine::initText() {
+    PROFILE_ZONE("Engine::initText");
+    const vec3 white = {1, 1, 1};
+    const vec3 red = {1, 0, 0};
+
+    // Start screen
+    startText = make_unique<TextLayout>(*fontRenderer);
+    startText->addLine("Choose a difficulty:", width/2, height - 200, 1.2, white, TextAlign::Center);
+    // the difficulties are a left aligned column, centered as a whole
+    const string difficulties[] = {"Easy (e)", "Normal (n)", "Hard (h)", "Random (r)"};
+    float columnWidth = 0;
+    for (const string &difficulty : difficulties) {
+        columnWidth = std::max(columnWidth, fontRenderer->measure(difficulty.data(), difficulty.length(), 1));
+    }
+    for (int i = 0; i < 4; ++i) {
+        startText->addLine(difficulties[i], width/2 - columnWidth/2, height - 300 - 50 * i, 1, white);
+    }
+    // text for instructions
+    startText->addLine("Instructions:", width/2, 190, 1, white, TextAlign::Center);
+    // this is red
+    startText->addLine("Arrow keys (Left, Right) to move!", width/2, 150, .75, red, TextAlign::Center);
+    startText->addLine("Hit ball into bricks to break them!", width/2, 125, .75, red, TextAlign::Center);
+    startText->addLine("Break all bricks to win! Have fun :D", width/2, 100, .75, red, TextAlign::Center);
+
+    // End screens
+    winText = make_unique<TextLayout>(*fontRenderer);
+    loseText = make_unique<TextLayout>(*fontRenderer);
+    winText->addLine("You win :)", width/2, height/2, 1, white, TextAlign::Center);
+    loseText->addLine("You lose :(", width/2, height/2, 1, white, TextAlign::Center);
+    for (TextLayout *text : {winText.get(), loseText.get()}) {
+        text->addLine("Press p to play again!", width/2, height/2.5, 1, white, TextAlign::Center);
+        text->addLine("Press esc to quit!", width/2, height/2.75, 1, white, TextAlign::Center);
+    }
+
+    // Gameplay, the death counter is updated in render() when it changes
+    pressSpaceText = make_unique<TextLayout>(*fontRenderer);
+    pressSpaceText->addLine("Press space to start", width/2, height/2, 1, white, TextAlign::Center);
+    deathText = make_unique<TextLayout>(*fontRenderer);
+    deathText->addLine("", 10, 20, .5, white);
+
+    perfHud = make_unique<PerfHud>(*fontRenderer, 10, height - 10);
+    if (config.showHud) {
+        perfHud->toggle();
+    }
 }
 
 void Engine::initShapes() {
-    srand(time(NULL));
+    reseed();
+    initShapes(buildLevels(levelSeed()));
+}
+
+void Engine::initShapes(const LevelSpecs &levels) {
     // Red paddle at bottom middle of screen
     paddle = make_unique<Rect>(shapeShader, vec2{width / 2, height / 4}, vec2{200, 15}, color{1, 0, 0, 1});
     // White ball just above paddle
     ball = make_unique<Circle>(shapeShader, vec2{width / 2, height / 3}, 2.25,color{1, 1, 1, 1});
     ball->setVelocity(vec2{0, 0});
 
-    // Create game state for easy
-    int x = 950;
-    int y = 725;
-    // Change color for each subsequent line
-    color currColor = color(.7,0,.5,1);
-    for (int i = 0; i < 29; ++i) {
-        if (x > 25) {
-            bricksEasy.push_back(make_unique<Rect>(shapeShader, vec2{x, y}, vec2{85, 40}, currColor));
-            x -= 100;
-        }
-        else {
-            // Else block for changing color based off of y position
-            y -= 50;
-            if (y < 725 && y >= 675) {
-                x = 900;
-                // Change color for each subsequent line
-                currColor = color(.5,.9,0,1);
-            }
-            if (y < 675 && y >= 625) {
-                // Change color for each subsequent line
-                currColor = color(0,.5,.7,1);
-                x = 950;
-            }
-            --i;
+    // Create the game state of every difficulty
+    vector<unique_ptr<Shape>> *bricks[] = {&bricksEasy, &bricksNormal, &bricksHard, &bricksRandom};
+    for (size_t level = 0; level < levels.size(); ++level) {
+        for (const BrickSpec &brick : levels[level]) {
+            bricks[level]->push_back(make_unique<Rect>(shapeShader, brick.pos, brick.size, brick.fill));
         }
     }
+}
 
-    // Create game state for normal
-    x = 950;
-    y = 725;
-    // Change color for each subsequent line
-    currColor = color(.7,0,.5,1);
-    for (int i = 0; i < 38; ++i) {
-        if (x > 25) {
-            if (i % 2 == 0) {
-                bricksNormal.push_back(make_unique<Rect>(shapeShader, vec2{x, y}, vec2{85, 40}, currColor));
-            }
-            x -= 100;
-        }
-        else {
-            // Else block for changing color based off of y position
-            y -= 50;
-            if (y < 725 && y >= 675) {
-                // Change color for each subsequent line
-                currColor = color(.5,.9,0,1);
-                x = 900;
-            }
-            if (y < 675 && y >= 625) {
-                // Change color for each subsequent line
-                currColor = color(0,.5,.7,1);
-                x = 950;
-            }
-            if (y < 625 && y >= 575) {
-                // Change color for each subsequent line
-                currColor = color(.7,.3,.7,1);
-                x = 900;
-            }
-            --i;
-        }
-    }
-
-    // Create game state for hard
-    x = 900;
-    y = 725;
-    currColor = color(.7,0,.5,1);
-    for (int i = 0; i < 38; ++i) {
-        if (x > 25) {
-            bricksHard.push_back(make_unique<Rect>(shapeShader, vec2{x, y}, vec2{85, 40}, currColor));
-            x -= 100;
-        }
-        else {
-            // Else block for changing color based off of y position
-            y -= 50;
-            if (y < 725 && y >= 675) {
-                // Change color for each subsequent line
-                currColor = color(.5,.9,0,1);
-                x = 950;
-            }
-            if (y < 675 && y >= 625) {
-                // Change color for each subsequent line
-                currColor = color(0,.5,.7,1);
-                x = 900;
-            }
-            if (y < 625 && y >= 575) {
-                // Change color for each subsequent line
-                currColor = color(.7,.3,.7,1);
-                x = 950;
-            }
-            --i;
-        }
-    }
+void Engine::reseed() {
+    // A benchmark was seeded once in the constructor, so every run plays the same game
+    if (config.benchmarkReport.empty())
+        srand(time(NULL));
+}
 
-    // Create game state for random
-    x = 950;
-    y = 725;
-    for (int i = 0; i < 40; ++i) {
-        if (x > 25) {
-            // A one in five chance to add each block to the vector
-            if (rand() % 5 == 0) {
-                // Add the brick with a random color
-                bricksRandom.push_back(make_unique<Rect>(shapeShader, vec2{x, y}, vec2{85, 40}, color(float(rand() % 10 / 10.0), float(rand() % 10 / 10.0), float(rand() % 10 / 10.0),.95)));
-            }
-            x -= 100;
-        }
-        else {
-            // Decrement y position and reset x to the left
-            y -= 50;
-            x = 950;
-            --i;
-        }
-    }
-    // If no bricks at all get added, add one brick
-    if (bricksRandom.size() == 0) {
-        bricksRandom.push_back(make_unique<Rect>(shapeShader, vec2{500, 750}, vec2{85, 40}, color(float(rand() % 10 / 10.0), float(rand() % 10 / 10.0), float(rand() % 10 / 10.0),.95)));
-    }
+unsigned int Engine::levelSeed() const {
+    return config.benchmarkReport.empty() ? static_cast<unsigned int>(time(NULL)) : EngineConfig::benchmarkSeed;
 }
 
 void Engine::processInput() {
-    glfwPollEvents();
-    srand(time(NULL));
+    PROFILE_ZONE("Engine::processInput");
+    ALLOCATION_SCOPE("Input");
+    reseed();
+
+    // Without a window there is no input, so every key stays released
+    if (!config.headless) {
+        glfwPollEvents();
+
+        // Set keys to true if pressed, false if released
+        for (int key = 0; key < 1024; ++key) {
+            if (glfwGetKey(window, key) == GLFW_PRESS)
+                keys[key] = true;
+            else if (glfwGetKey(window, key) == GLFW_RELEASE)
+                keys[key] = false;
+        }
 
-    // Set keys to true if pressed, false if released
-    for (int key = 0; key < 1024; ++key) {
-        if (glfwGetKey(window, key) == GLFW_PRESS)
-            keys[key] = true;
-        else if (glfwGetKey(window, key) == GLFW_RELEASE)
-            keys[key] = false;
+        // Close window if escape key is pressed
+        if (keys[GLFW_KEY_ESCAPE])
+            glfwSetWindowShouldClose(window, true);
+
+        // Mouse position saved to check for collisions
+        glfwGetCursorPos(window, &MouseX, &MouseY);
     }
 
-    // Close window if escape key is pressed
-    if (keys[GLFW_KEY_ESCAPE])
-        glfwSetWindowShouldClose(window, true);
+    // A benchmark plays itself: the script decides every key from what is on screen
+    if (session) {
+        SessionView view;
+        view.screen = screen == start ? SessionView::Screen::Menu
+                    : screen == win || screen == lose ? SessionView::Screen::GameOver
+                    : SessionView::Screen::Playing;
+        view.ballPos = ball->getPos();
+        view.ballVelocity = ball->getVelocity();
+        view.paddleX = paddle->getPos().x;
+        view.screenWidth = width;
+        session->press(view, keys);
+    }
 
-    // Mouse position saved to check for collisions
-    glfwGetCursorPos(window, &MouseX, &MouseY);
+    // F1 shows or hides the performance overlay
+    if (keys[GLFW_KEY_F1] && !hudKeyLastFrame) {
+        perfHud->toggle();
+    }
+    hudKeyLastFrame = keys[GLFW_KEY_F1];
+
+    // Print the GL call counters of the last frame when F2 is pressed
+    if (keys[GLFW_KEY_F2] && !statsKeyLastFrame) {
+        cout << "GL calls last frame: " << lastFrameStats.total()
+             << " (uniform lookups: " << lastFrameStats.uniformLookups
+             << ", uniform uploads: " << lastFrameStats.uniformUploads
+             << ", draw calls: " << lastFrameStats.drawCalls
+             << ", state changes: " << lastFrameStats.stateChanges
+             << ", buffer uploads: " << lastFrameStats.bufferUploads << ")" << endl;
+        AllocationTracker::printLastFrame();
+    }
+    statsKeyLastFrame = keys[GLFW_KEY_F2];
+
+    // F3 prints the profiler's zone percentiles and starts timing the GPU, F4 writes a trace of the last frames
+    if (keys[GLFW_KEY_F3] && !profileKeyLastFrame) {
+        Profiler::printStats();
+        renderer->setGpuTiming(true);
+    }
+    profileKeyLastFrame = keys[GLFW_KEY_F3];
+    if (keys[GLFW_KEY_F4] && !traceKeyLastFrame) {
+        Profiler::writeTrace("trace.json");
+    }
+    traceKeyLastFrame = keys[GLFW_KEY_F4];
 
     // If we're in the start screen and press any of the modes; change screen to mode
     if (screen == start) {
@@ -227,6 +324,7 @@ void Engine::processInput() {
     && deathCounter == 3) {
         screen = lose;
         initShapes();
+        particles->clear();
     }
     // If you win or lose; reset ball and blocks and press p to start over
     if ((screen == lose || screen == win)
@@ -235,6 +333,7 @@ void Engine::processInput() {
         ball->setPos(vec2{width / 2, height / 3});
         deathCounter = 0;
         initShapes();
+        particles->clear();
         screen = start;
     }
 
@@ -406,14 +505,24 @@ void Engine::checkBounds(unique_ptr<Circle> &ball) const {
     ball->setVelocity(velocity);
 }
 
+void Engine::breakBrick(Shape &brick) {
+    // The debris flies off with some of the ball's speed
+    particles->emitBurst(brick.getPos(), brick.getSize(), brick.getColor4(), ball->getVelocity(), particlesPerBrick);
+    brick.setPos(vec2{-1000,-1000});
+}
+
 void Engine::update() {
-    srand(time(NULL));
+    PROFILE_ZONE("Engine::update");
+    ALLOCATION_SCOPE("Game");
+    simTicks++;
+    reseed();
     // Calculate delta time
-    float currentFrame = glfwGetTime();
+    float currentFrame = getTime();
     deltaTime = currentFrame - lastFrame;
     lastFrame = currentFrame;
 
     checkBounds(ball);
+    particles->update(deltaTime);
     if (screen == easy) {
         if (ball->isOverlappingPaddle(*ball, *paddle)) {
             // add randomness so that the ball might bounce slightly left or right
@@ -422,7 +531,7 @@ void Engine::update() {
         for(const unique_ptr<Shape> &brick : bricksEasy) {
             if (ball->isOverlappingPaddle(*ball, *brick)) {
                 ball->setVelocity(-ball->getVelocity());
-                brick->setPos(vec2{-1000,-1000});
+                breakBrick(*brick);
             }
         }
     }
@@ -439,7 +548,7 @@ void Engine::update() {
         for(const unique_ptr<Shape> &brick : bricksNormal) {
             if (ball->isOverlappingPaddle(*ball, *brick)) {
                 ball->setVelocity(-ball->getVelocity());
-                brick->setPos(vec2{-1000,-1000});
+                breakBrick(*brick);
             }
         }
     }
@@ -451,7 +560,7 @@ void Engine::update() {
         for(const unique_ptr<Shape> &brick : bricksHard) {
             if (ball->isOverlappingPaddle(*ball, *brick)) {
                 ball->setVelocity(-ball->getVelocity());
-                brick->setPos(vec2{-1000,-1000});
+                breakBrick(*brick);
             }
         }
     }
@@ -463,7 +572,7 @@ void Engine::update() {
         for(const unique_ptr<Shape> &brick : bricksRandom) {
             if (ball->isOverlappingPaddle(*ball, *brick)) {
                 ball->setVelocity(-ball->getVelocity());
-                brick->setPos(vec2{-1000,-1000});
+                breakBrick(*brick);
             }
         }
     }
@@ -471,150 +580,217 @@ void Engine::update() {
 }
 
 void Engine::render() {
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // Set background color
-    glClear(GL_COLOR_BUFFER_BIT);
+    PROFILE_ZONE("Engine::render");
+    ALLOCATION_SCOPE("Render");
+
+    // The overlay shows the GL calls of the previous frame, which are complete by now
+    FrameCounters counters;
+    auto now = std::chrono::steady_clock::now();
+    if (frameIndex > 0) {
+        counters.frameMilliseconds = std::chrono::duration<float, std::milli>(now - lastRenderTime).count();
+    }
+    lastRenderTime = now;
+    counters.gl = lastFrameStats;
+    counters.simTicks = simTicks;
+    simTicks = 0;
+    AllocationCounts allocations = AllocationTracker::nextFrame();
+    if (AllocationTracker::enabled) {
+        counters.allocations = allocations.allocations;
+        counters.allocatedBytes = allocations.bytes;
+    }
+    perfHud->recordFrame(counters);
+    checkAllocationGate(allocations);
+
+    glStats.reset();
+    if (streamBuffer) {
+        streamBuffer->beginFrame();
+
+        // Frame-global uniforms are uploaded once and shared by all programs
+        FrameUniforms frame{};
+        frame.projection = PROJECTION;
+        frame.viewport = vec4(0, 0, width, height);
+        frame.time = static_cast<float>(getTime());
+        shaderManager->updateFrameUniforms(frame, *streamBuffer);
+    }
+
+    renderer->clear(vec4(0.0f, 0.0f, 0.0f, 1.0f)); // Set background color
 
-    // Set shader to draw shapes
-    shapeShader.use();
+    // Only lay the death counter out again when it changes
+    if (deathCounter != deathTextCount) {
+        deathTextCount = deathCounter;
+        FixedString<32> line;
+        line.append("Death Counts: ").append(deathCounter);
+        deathText->setText(0, line);
+    }
 
     // Render differently depending on screen
     switch (screen) {
         case start: {
-            string message = "Choose a difficulty:";
-            string easy = "Easy (e)";
-            string normal = "Normal (n)";
-            string hard = "Hard (h)";
-            string random = "Random (r)";
-            string instructionsTitle = "Instructions:";
-            string instructions1 = "Arrow keys (Left, Right) to move!";
-            string instructions2 = "Hit ball into bricks to break them!";
-            string instructions3 = "Break all bricks to win! Have fun :D";
-
-            // text for each game mode
-            this->fontRenderer->renderText(message, width/2 - (13.5 * message.length()), height - 200, projection, 1.2, vec3{1, 1, 1});
-            this->fontRenderer->renderText(easy, width/2 - (6 * message.length()), height - 300, projection, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(normal, width/2 - (6 * message.length()), height - 350, projection, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(hard, width/2 - (6 * message.length()), height - 400, projection, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(random, width/2 - (6 * message.length()), height - 450, projection, 1, vec3{1, 1, 1});
-            // text for instructions
-            this->fontRenderer->renderText(instructionsTitle, width/2 - (12 * instructionsTitle.length()), 190, projection, 1, vec3{1, 1, 1});
-            // this is red
-            this->fontRenderer->renderText(instructions1, width/2 - (9 * instructions1.length()), 150, projection, .75, vec3{1, 0, 0});
-            this->fontRenderer->renderText(instructions2, width/2 - (9 * instructions2.length()), 125, projection, .75, vec3{1, 0, 0});
-            this->fontRenderer->renderText(instructions3, width/2 - (9 * instructions3.length()), 100, projection, .75, vec3{1, 0, 0});
+            renderer->submit(*startText);
             break;
         }
         case easy: {
-            ball->setUniforms();
-            ball->draw();
-            paddle->setUniforms();
-            paddle->draw();
+            renderer->submit(*ball, RenderLayer::Actors);
+            renderer->submit(*paddle, RenderLayer::Actors);
 
             for (int i = 0; i < bricksEasy.size(); ++i) {
-                bricksEasy[i]->setUniforms();
-                bricksEasy[i]->draw();
+                renderer->submit(*bricksEasy[i], RenderLayer::Bricks);
             }
 
-            string message1 = "Death Counts: " + std::to_string(deathCounter);
-            // Display the message on the screen
-            this->fontRenderer->renderText(message1, 10, 20, projection, .5, vec3{1, 1, 1});
-
-            string message = "Press space to start";
+            // Display the death counter and, before launch, the prompt
+            renderer->submit(*deathText);
             if (ball->getVelocity() == vec2(0,0)) {
-                this->fontRenderer->renderText(message, width/2 - (12 * message.length()), height/2, projection, 1, vec3{1, 1, 1});
+                renderer->submit(*pressSpaceText);
             }
             break;
         }
         case normal: {
 
-            ball->setUniforms();
-            ball->draw();
-            paddle->setUniforms();
-            paddle->draw();
+            renderer->submit(*ball, RenderLayer::Actors);
+            renderer->submit(*paddle, RenderLayer::Actors);
 
             for (int i = 0; i < bricksNormal.size(); ++i) {
-                bricksNormal[i]->setUniforms();
-                bricksNormal[i]->draw();
+                renderer->submit(*bricksNormal[i], RenderLayer::Bricks);
             }
 
-            string message1 = "Death Counts: " + std::to_string(deathCounter);
-            // Display the message on the screen
-            this->fontRenderer->renderText(message1, 10, 20, projection, .5, vec3{1, 1, 1});
-
-            string message = "Press space to start";
+            // Display the death counter and, before launch, the prompt
+            renderer->submit(*deathText);
             if (ball->getVelocity() == vec2(0,0)) {
-                this->fontRenderer->renderText(message, width/2 - (12 * message.length()), height/2, projection, 1, vec3{1, 1, 1});
+                renderer->submit(*pressSpaceText);
             }
             break;
         }
         case hard: {
-            ball->setUniforms();
-            ball->draw();
-            paddle->setUniforms();
-            paddle->draw();
+            renderer->submit(*ball, RenderLayer::Actors);
+            renderer->submit(*paddle, RenderLayer::Actors);
 
             for (int i = 0; i < bricksHard.size(); ++i) {
-                bricksHard[i]->setUniforms();
-                bricksHard[i]->draw();
+                renderer->submit(*bricksHard[i], RenderLayer::Bricks);
             }
 
-            string message1 = "Death Counts: " + std::to_string(deathCounter);
-            // Display the message on the screen
-            this->fontRenderer->renderText(message1, 10, 20, projection, .5, vec3{1, 1, 1});
-
-            string message = "Press space to start";
+            // Display the death counter and, before launch, the prompt
+            renderer->submit(*deathText);
             if (ball->getVelocity() == vec2(0,0)) {
-                this->fontRenderer->renderText(message, width/2 - (12 * message.length()), height/2, projection, 1, vec3{1, 1, 1});
+                renderer->submit(*pressSpaceText);
             }
             break;
         }
         case random_: {
-            ball->setUniforms();
-            ball->draw();
-            paddle->setUniforms();
-            paddle->draw();
+            renderer->submit(*ball, RenderLayer::Actors);
+            renderer->submit(*paddle, RenderLayer::Actors);
 
             for (int i = 0; i < bricksRandom.size(); ++i) {
-                bricksRandom[i]->setUniforms();
-                bricksRandom[i]->draw();
+                renderer->submit(*bricksRandom[i], RenderLayer::Bricks);
             }
 
-            string message1 = "Death Counts: " + std::to_string(deathCounter);
-            // Display the message on the screen
-            this->fontRenderer->renderText(message1, 10, 20, projection, .5, vec3{1, 1, 1});
-
-            string message = "Press space to start";
+            // Display the death counter and, before launch, the prompt
+            renderer->submit(*deathText);
             if (ball->getVelocity() == vec2(0,0)) {
-                this->fontRenderer->renderText(message, width/2 - (12 * message.length()), height/2, projection, 1, vec3{1, 1, 1});
+                renderer->submit(*pressSpaceText);
             }
             break;
         }
         case win: {
-            string message1 = "You win :)";
-            string message2 = "Press p to play again!";
-            string message3 = "Press esc to quit!";
-            // Display the message on the screen
-            this->fontRenderer->renderText(message1, width/2 - (12 * message1.length()), height/2, projection, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(message2, width/2 - (12 * message2.length()), height/2.5, projection, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(message3, width/2 - (12 * message3.length()), height/2.75, projection, 1, vec3{1, 1, 1});
+            renderer->submit(*winText);
             break;
         }
         case lose: {
-            string message1 = "You lose :(";
-            string message2 = "Press p to play again!";
-            string message3 = "Press esc to quit!";
-            // Display the message on the screen
-            this->fontRenderer->renderText(message1, width/2 - (12 * message1.length()), height/2, projection, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(message2, width/2 - (12 * message2.length()), height/2.5, projection, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(message3, width/2 - (12 * message3.length()), height/2.75, projection, 1, vec3{1, 1, 1});
+            renderer->submit(*loseText);
             break;
         }
     }
-    glfwSwapBuffers(window);
+    // Debris of broken bricks, above the bricks and below the text
+    renderer->submit(*particles, RenderLayer::Actors);
+    perfHud->submit(*renderer);
+
+    // Sort and draw everything submitted this frame
+    renderer->flush();
+
+    if (!config.captureDirectory.empty() && frameIndex % config.captureEvery == 0) {
+        captureFrame();
+    }
+    if (recorder) {
+        if (const unsigned char *pixels = renderer->getPixels())
+            recorder->capture(frameIndex, pixels);
+        else
+            recorder->capture(frameIndex);
+    }
+    if (streamBuffer) {
+        streamBuffer->endFrame();
+    }
+
+    // Wait for the GPU when benchmarking, so the render time covers the drawing and not just the submission
+    if (session && config.needsContext()) {
+        PROFILE_ZONE("Engine::finish");
+        glFinish();
+    }
+
+    if (!config.headless) {
+        PROFILE_ZONE("Engine::swapBuffers");
+        glfwSwapBuffers(window);
+    }
+    lastFrameStats = glStats;
+    frameIndex++;
+}
+
+void Engine::checkAllocationGate(const AllocationCounts &allocations) {
+    // Changing screens rebuilds the level, so only frames that stay on one screen are checked
+    framesOnScreen = screen == screenLastFrame ? framesOnScreen + 1 : 0;
+    screenLastFrame = screen;
+    if (config.allocationGate < 0 || framesOnScreen <= config.allocationGate || allocations.allocations == 0)
+        return;
+
+    allocationGateFailures++;
+    cout << "ERROR::ALLOCATION: Frame " << frameIndex << " allocated " << allocations.allocations << " times ("
+         << allocations.bytes << " bytes) after warm-up" << endl;
+    AllocationTracker::printLastFrame();
+}
+
+int Engine::getAllocationGateFailures() const {
+    return allocationGateFailures;
+}
+
+double Engine::getTime() const {
+    if (config.fixedDeltaTime > 0) {
+        return frameIndex * static_cast<double>(config.fixedDeltaTime);
+    }
+    if (config.headless) {
+        // GLFW is not initialized when headless
+        static const auto start = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return glfwGetTime();
+}
+
+void Engine::captureFrame() {
+    if (frameIndex == 0) {
+        std::error_code error;
+        std::filesystem::create_directories(config.captureDirectory, error);
+    }
+
+    // Frames drawn on the CPU are written as they are; otherwise read from the framebuffer that was just
+    // drawn (the back buffer or the offscreen FBO)
+    const unsigned char *pixels = renderer->getPixels();
+    if (pixels == nullptr) {
+        capturePixels.resize(width * height * 4);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, capturePixels.data());
+        pixels = capturePixels.data();
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "/frame_%05d.png", frameIndex);
+    string path = config.captureDirectory + name;
+    if (!writePng(path, width, height, pixels)) {
+        cout << "ERROR::CAPTURE: Failed to write " << path << endl;
+    }
 }
 
 bool Engine::shouldClose() {
-    return glfwWindowShouldClose(window);
+    if (config.frames > 0 && frameIndex >= config.frames) {
+        return true;
+    }
+    return !config.headless && glfwWindowShouldClose(window);
 }
 
 GLenum Engine::glCheckError_(const char *file, int line) {
@@ -1,14 +1,26 @@
 #ifndef GRAPHICS_ENGINE_H
 #define GRAPHICS_ENGINE_H
 
+#include <chrono>
 #include <ctime>
 #include <vector>
 #include <memory>
+#include <future>
 #include <iostream>
 #include <GLFW/glfw3.h>
 
 #include "framework/shaderManager.h"
 #include "font/fontRenderer.h"
+#include "font/textLayout.h"
+#include "framework/glRenderer.h"
+#include "framework/softwareRenderer.h"
+#include "framework/engineConfig.h"
+#include "framework/headlessContext.h"
+#include "framework/perfHud.h"
+#include "framework/particleSystem.h"
+#include "framework/allocationTracker.h"
+#include "levels.h"
+#include "scriptedSession.h"
 #include "shapes/shape.h"
 #include "shapes/rect.h"
 #include "shapes/circle.h"
@@ -21,27 +33,52 @@ using std::vector, std::unique_ptr, std::make_unique, glm::ortho, glm::mat4, glm
  */
 class Engine {
 private:
-    /// @brief The actual GLFW window.
+    /// @brief Startup options (headless, fixed time step, frame capture, ...).
+    EngineConfig config;
+
+    /// @brief The actual GLFW window (nullptr when headless).
     GLFWwindow* window{};
 
+    /// @brief The offscreen context used instead of the window when headless (nullptr with --software).
+    /// @details Declared before every GL resource so it is destroyed after them.
+    unique_ptr<HeadlessContext> headlessContext;
+
+    /// @brief Number of frames rendered so far
+    int frameIndex = 0;
+
+    /// @brief Pixels of the last frame read back for capture, reused between captures
+    vector<unsigned char> capturePixels;
+
+    /// @brief Records every frame when config.recordTarget is set (nullptr otherwise)
+    unique_ptr<FrameRecorder> recorder;
+
     /// @brief The width and height of the window.
     const unsigned int width = 1000, height = 800; // Window dimensions
-    /// @brief The projection matrix
-    const glm::mat4 projection = glm::ortho(0.0f, (float)width, 0.0f, (float)height);
 
 
     /// @brief Keyboard state (True if pressed, false if not pressed).
     /// @details Index this array with GLFW_KEY_{key} to get the state of a key.
     bool keys[1024];
 
+    /// @brief Presses the keys instead of the player when config.benchmarkReport is set (nullptr otherwise)
+    unique_ptr<ScriptedSession> session;
+
+    /// @brief Ring buffer every per-frame upload (text quads, frame uniforms) goes through.
+    /// @details Initialized in initShaders(); nullptr without a GL context (see EngineConfig::needsContext())
+    unique_ptr<StreamBuffer> streamBuffer;
+
     /// @brief Responsible for loading and storing all the shaders used in the project.
-    /// @details Initialized in initShaders()
+    /// @details Initialized in initShaders(); nullptr without a GL context
     unique_ptr<ShaderManager> shaderManager;
 
     /// @brief Responsible for rendering text on the screen.
     /// @details Initialized in initShaders()
     unique_ptr<FontRenderer> fontRenderer;
 
+    /// @brief Collects the draws of a frame and replays them sorted by state.
+    /// @details Initialized in initShaders(); a GLRenderer, or a SoftwareRenderer with --software
+    unique_ptr<Renderer> renderer;
+
     // Shapes
     unique_ptr<Shape> paddle;
     unique_ptr<Circle> ball;
@@ -50,6 +87,36 @@ private:
     vector<unique_ptr<Shape>> bricksHard;
     vector<unique_ptr<Shape>> bricksRandom;
 
+    /// @brief Debris of broken bricks
+    /// @details Initialized in the constructor, emptied whenever the game ends.
+    unique_ptr<ParticleSystem> particles;
+
+    // Text
+    /// @brief Cached text blocks, one per screen.
+    /// @details Initialized in initText()
+    unique_ptr<TextLayout> startText;
+    unique_ptr<TextLayout> winText;
+    unique_ptr<TextLayout> loseText;
+    unique_ptr<TextLayout> pressSpaceText;
+    unique_ptr<TextLayout> deathText;
+    /// @brief The death count deathText currently shows (-1 before the first frame)
+    int deathTextCount = -1;
+
+    /// @brief Performance overlay, toggled with F1
+    /// @details Initialized in initText()
+    unique_ptr<PerfHud> perfHud;
+    bool hudKeyLastFrame = false;
+    /// @brief Game updates since the last rendered frame
+    int simTicks = 0;
+    /// @brief When the last frame started rendering, for the frame time
+    std::chrono::steady_clock::time_point lastRenderTime;
+
+    /// @brief Frames rendered in a row on the current screen, and the screen of the last frame
+    /// @details Used by the allocation gate to skip the frames that change screens.
+    int framesOnScreen = 0, screenLastFrame = -1;
+    /// @brief Frames that failed the allocation gate (see EngineConfig::allocationGate)
+    int allocationGateFailures = 0;
+
     // Shaders
     Shader shapeShader;
     Shader textShader;
@@ -57,6 +124,12 @@ private:
     double MouseX, MouseY;
     bool mousePressedLastFrame = false;
 
+    /// @brief GL call counters of the last rendered frame
+    /// @details Printed to the console when F2 is pressed.
+    GLStats lastFrameStats;
+    bool statsKeyLastFrame = false;
+    bool profileKeyLastFrame = false, traceKeyLastFrame = false;
+
     /// @note Call glCheckError() after every OpenGL call to check for errors.
     GLenum glCheckError_(const char *file, int line);
     /// @brief Macro for glCheckError_ function. Used for debugging.
@@ -64,23 +137,52 @@ private:
 
 public:
     /// @brief Constructor for the Engine class.
-    /// @details Initializes window and shaders.
-    Engine();
+    /// @details Initializes window (or offscreen context) and shaders.
+    /// @param config Startup options, see EngineConfig::parse()
+    explicit Engine(const EngineConfig &config = EngineConfig());
 
     /// @brief Destructor for the Engine class.
     ~Engine();
 
-    /// @brief Initializes the GLFW window.
+    /// @brief Initializes the GLFW window, or the offscreen context when headless (none with --software).
     /// @return 0 if successful, -1 otherwise.
     unsigned int initWindow(bool debug = false);
 
-    /// @brief Loads shaders from files and stores them in the shaderManager.
+    /// @brief Returns the game time in seconds
+    /// @details Advances by config.fixedDeltaTime per frame when set, otherwise follows the real clock.
+    double getTime() const;
+
+    /// @brief Writes the rendered frame to config.captureDirectory as a PNG file
+    void captureFrame();
+
+    /// @brief Counts the frame as a failure if it allocated after warm-up and the allocation gate is on
+    /// @details Prints the allocations of the frame per subsystem.
+    void checkAllocationGate(const AllocationCounts &allocations);
+
+    /// @brief Returns the number of frames that failed the allocation gate
+    int getAllocationGateFailures() const;
+
+    /// @brief Loads the shaders and stores them in the shaderManager.
     /// @details Renderers are initialized here.
-    void initShaders();
+    /// @param font The text font, being loaded on a worker thread; waited for once every program is built
+    void initShaders(std::future<unique_ptr<Font>> &font);
 
     /// @brief Initializes the shapes to be rendered.
+    /// @details Reseeds rand() and builds new levels (see reseed() and levelSeed()), e.g. to start over.
     void initShapes();
 
+    /// @brief Seeds rand() with the time; does nothing when benchmarking, see EngineConfig::benchmarkSeed
+    void reseed();
+
+    /// @brief Returns the seed of the random level: the time, or EngineConfig::benchmarkSeed when benchmarking
+    unsigned int levelSeed() const;
+
+    /// @brief Initializes the shapes to be rendered, with bricks of levels built beforehand.
+    void initShapes(const LevelSpecs &levels);
+
+    /// @brief Lays out the text of every screen.
+    void initText();
+
     /// @brief Pushes back a new colored rectangle to the confetti vector.
 //    void spawnConfetti();
 
@@ -91,6 +193,9 @@ public:
     /// @brief Checks position of a given circle
     /// @details Keeps it from leaving the window
     void checkBounds(unique_ptr<Circle> &bubble) const;
+
+    /// @brief Removes a brick the ball hit from play and bursts it into particles
+    void breakBrick(Shape &brick);
     /// @brief Updates the game state.
     /// @details (e.g. collision detection, delta time, etc.)
     void update();
@@ -111,13 +216,14 @@ public:
     /// @details (Wrapper for glfwWindowShouldClose()).
     /// @return true if the window should close
     /// @return false if the window should not close
+    /// @details Also true once config.frames frames have been rendered.
     bool shouldClose();
 
     /// Projection matrix used for 2D rendering (orthographic projection).
     /// We don't have to change this matrix since the screen size never changes.
     /// OpenGL uses the projection matrix to map the 3D scene to a 2D viewport.
     /// The projection matrix transforms coordinates in the camera space into normalized device coordinates (view space to clip space).
-    /// @note The projection matrix is used in the vertex shader.
+    /// @note The projection matrix reaches the vertex shaders through the FrameData uniform block.
     // 4th quadrant
     mat4 PROJECTION = ortho(0.0f, static_cast<float>(width), 0.0f, static_cast<float>(height), -1.0f, 1.0f);
     // 1st quadrant
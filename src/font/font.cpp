@@ -1,77 +1,409 @@
 #include "font.h"
 #include <glad/glad.h>
+#include FT_MODULE_H
 
+#include "../util/cacheDirectory.h"
+#include "../util/hash.h"
+#include "../util/mappedFile.h"
+#include "../framework/allocationTracker.h"
+#include "../framework/profiler.h"
+#include "../framework/resources.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <thread>
+
+namespace {
+    /**
+     * @brief Layout of the start of a cache file
+     * @details Followed by glyphCount CachedGlyph records and atlasWidth * rows bytes of page 0.
+     * The file is only read back by the build that wrote it, so structs are stored as they are in memory.
+     */
+    struct CacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t atlasWidth, rows;
+        uint32_t glyphCount;
+        float scale;
+    };
+
+    struct CachedGlyph {
+        uint32_t code;
+        Character character;
+    };
+
+    const char cacheMagic[4] = {'F', 'N', 'T', 'C'};
+    // bump when the rasterization or the file layout changes
+    const uint32_t cacheVersion = 2;
+}
+
+Font::Font(std::string_view fontName, unsigned int fontSize, FontMode mode)
+    : fontData(Resources::get(fontName)), fontSize(fontSize), mode(mode) {
+    // The time it takes shows up in traces as this zone, split into Font::loadCache and Font::rasterizeAscii
+    PROFILE_ZONE("Font::load");
 
-Font::Font(std::string fontPath, unsigned int fontSize) {
-    FT_Library ft;
+    // Distance fields are rasterized once at a fixed size and scaled to the requested one
+    if (mode == FontMode::SDF)
+        scale = float(fontSize) / float(sdfRasterSize);
+
+    // every page but the ASCII one starts out empty
+    pages.assign(pageCount, Page{glyphPadding, glyphPadding, 0, 0, true});
+    pages[0].empty = false;
+    atlasPixels.assign(size_t(atlasWidth) * pageHeight * pageCount, 0);
+
+    // The font file itself is part of the cache key, so editing it invalidates the cache
+    std::string cachePath = getCachePath(reinterpret_cast<const unsigned char *>(fontData.data()), fontData.size(),
+                                         fontSize, mode);
+
+    if (!loadCache(cachePath)) {
+        std::vector<unsigned char> atlas;
+        asciiRows = rasterizeAscii(atlas);
+        std::copy(atlas.begin(), atlas.end(), atlasPixels.begin());
+        saveCache(cachePath, atlas, asciiRows);
+    }
+}
 
+Font::~Font() {
+    if (face)
+        FT_Done_Face(face);
+    if (ft)
+        FT_Done_FreeType(ft);
+}
+
+const Character &Font::getGlyph(uint32_t codepoint) {
+    const Character *character = Characters.find(codepoint);
+    if (!character)
+        return loadGlyph(codepoint);
+    // page 0 is never evicted, so only the other pages need to know they were used
+    if (character->Page != 0)
+        pages[character->Page].lastUsed = ++useClock;
+    return *character;
+}
+
+bool Font::openFace() {
+    return face || createFace(ft, face);
+}
+
+bool Font::createFace(FT_Library &library, FT_Face &newFace) const {
     // Initialize FreeType library
-    if (FT_Init_FreeType(&ft)) {
+    if (FT_Init_FreeType(&library)) {
         std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+        library = nullptr;
+        return false;
     }
 
     // Load font as face
-    FT_Face face;
-    if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
+    if (FT_New_Memory_Face(library, reinterpret_cast<const FT_Byte *>(fontData.data()),
+                           static_cast<FT_Long>(fontData.size()), 0, &newFace)) {
         std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
+        FT_Done_FreeType(library);
+        library = nullptr;
+        newFace = nullptr;
+        return false;
+    }
+
+    unsigned int rasterSize = fontSize;
+    if (mode == FontMode::SDF) {
+        rasterSize = sdfRasterSize;
+        // the field is built from the rendered bitmap ("bsdf"), which copes with the
+        // overlapping contours pixel fonts are made of better than the outline rasterizer
+        FT_Int spread = sdfSpread;
+        FT_Property_Set(library, "bsdf", "spread", &spread);
     }
 
     // Set size to load glyphs as
-    FT_Set_Pixel_Sizes(face, 0, fontSize);
+    FT_Set_Pixel_Sizes(newFace, 0, rasterSize);
+    return true;
+}
 
-    // Attempt to load character glyph
-    if (FT_Load_Char(face, 'X', FT_LOAD_RENDER)) {
+bool Font::renderGlyph(FT_Face glyphFace, uint32_t codepoint, Bitmap &glyph) const {
+    // load character glyph
+    if (FT_Load_Char(glyphFace, codepoint, FT_LOAD_RENDER)) {
         std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
+        return false;
+    }
+    // re-rendering the coverage bitmap in SDF mode turns it into a distance field
+    if (mode == FontMode::SDF && glyphFace->glyph->bitmap.width > 0
+        && FT_Render_Glyph(glyphFace->glyph, FT_RENDER_MODE_SDF)) {
+        std::cout << "ERROR::FREETYTPE: Failed to render SDF Glyph" << std::endl;
     }
 
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // disable byte-alignment restriction
+    const FT_Bitmap &bitmap = glyphFace->glyph->bitmap;
+    int w = bitmap.width, h = bitmap.rows;
+    glyph.codepoint = codepoint;
+    glyph.pixels.resize(w * h);
+    for (int row = 0; row < h; ++row)
+        std::copy_n(bitmap.buffer + row * bitmap.pitch, w, glyph.pixels.begin() + row * w);
+
+    // UVs and page are filled in once the glyph has a place in the atlas
+    glyph.character = {
+        glm::vec4(0.0f),
+        glm::ivec2(w, h),
+        glm::ivec2(glyphFace->glyph->bitmap_left, glyphFace->glyph->bitmap_top),
+        static_cast<unsigned int>(glyphFace->glyph->advance.x),
+        0
+    };
+    return true;
+}
+
+int Font::rasterizeAscii(std::vector<unsigned char> &atlas) {
+    // Glyph bitmaps are rasterized first, spread over several threads, and copied into the atlas once its
+    // height is known
+    std::vector<Bitmap> bitmaps(128);
+    std::vector<char> rendered(128, 0);
+    const unsigned int threadCount = std::clamp(std::thread::hardware_concurrency(), 1u, maxRasterThreads);
+    auto rasterize = [&](unsigned int first) {
+        PROFILE_ZONE("Font::rasterizeAscii");
+        // FreeType objects must not be shared between threads, so every thread opens the face for itself
+        FT_Library library;
+        FT_Face threadFace;
+        if (!createFace(library, threadFace))
+            return;
+        for (uint32_t c = first; c < 128; c += threadCount)
+            rendered[c] = renderGlyph(threadFace, c, bitmaps[c]);
+        FT_Done_Face(threadFace);
+        FT_Done_FreeType(library);
+    };
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < threadCount; i++) {
+        threads.emplace_back([&rasterize, i] {
+            Profiler::setThreadName("font raster");
+            rasterize(i);
+        });
+    }
+    rasterize(0);
+    for (std::thread &thread : threads)
+        thread.join();
 
-    // Load first 128 characters of ASCII set
-    for (unsigned char c = 0; c < 128; c++) {
-        // load character glyph 
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
+    // Shelf packing: glyphs are placed left to right, a new row starts when the current one is full
+    Page &page = pages[0];
+    for (uint32_t c = 0; c < 128; c++) {
+        if (!rendered[c])
+            continue;
+        Bitmap &glyph = bitmaps[c];
+
+        int w = glyph.character.Size.x, h = glyph.character.Size.y;
+        if (page.penX + w + glyphPadding > atlasWidth) {
+            page.penX = glyphPadding;
+            page.penY += page.rowHeight + glyphPadding;
+            page.rowHeight = 0;
+        }
+        if (page.penY + h + glyphPadding > pageHeight) {
+            std::cout << "ERROR::FONT: Glyph " << c << " does not fit in the atlas" << std::endl;
+            rendered[c] = false;
             continue;
         }
 
-        // generate texture
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            0,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
-        );
-
-        // set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        // now store character for later use
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            static_cast<unsigned int>(face->glyph->advance.x)
-        };
-        Characters.insert(std::pair<char, Character>(c, character));
-    }
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
-}
-
-std::map<char, Character> Font::getCharacters() const {
-    return Characters;
+        glyph.x = page.penX;
+        glyph.y = page.penY;
+        page.penX += w + glyphPadding;
+        page.rowHeight = std::max(page.rowHeight, h);
+    }
+
+    // Copy every glyph into the atlas and compute its texture coordinates
+    int rows = page.penY + page.rowHeight + glyphPadding;
+    atlas.assign(atlasWidth * rows, 0);
+    for (uint32_t c = 0; c < 128; c++) {
+        if (!rendered[c])
+            continue;
+        Bitmap &glyph = bitmaps[c];
+        Character &character = glyph.character;
+        int w = character.Size.x, h = character.Size.y;
+        for (int row = 0; row < h; ++row)
+            std::copy_n(glyph.pixels.begin() + row * w, w, atlas.begin() + (glyph.y + row) * atlasWidth + glyph.x);
+        character.UV = glm::vec4(float(glyph.x) / atlasWidth, float(glyph.y) / pageHeight,
+                                 float(glyph.x + w) / atlasWidth, float(glyph.y + h) / pageHeight);
+        Characters.insert(glyph.codepoint, character);
+    }
+    return rows;
+}
+
+const Character &Font::loadGlyph(uint32_t codepoint) {
+    PROFILE_ZONE("Font::loadGlyph");
+    ALLOCATION_SCOPE("Font");
+    Bitmap glyph;
+    if (!openFace() || !renderGlyph(face, codepoint, glyph)) {
+        // remember the failure as an empty character, so it is not retried every frame
+        return Characters.insert(codepoint, Character{});
+    }
+
+    // A glyph goes on the end of the current page's shelf, on a new shelf, or on an empty or evicted page
+    int w = glyph.character.Size.x, h = glyph.character.Size.y;
+    if (w + 2 * glyphPadding > atlasWidth || h + 2 * glyphPadding > pageHeight) {
+        std::cout << "ERROR::FONT: Glyph " << codepoint << " does not fit in the atlas" << std::endl;
+        return Characters.insert(codepoint, Character{});
+    }
+    Page *page = &pages[currentPage];
+    if (page->penX + w + glyphPadding > atlasWidth) {
+        page->penX = glyphPadding;
+        page->penY += page->rowHeight + glyphPadding;
+        page->rowHeight = 0;
+    }
+    if (page->penY + h + glyphPadding > pageHeight) {
+        auto emptyPage = std::find_if(pages.begin() + 1, pages.end(), [](const Page &p) { return p.empty; });
+        currentPage = emptyPage != pages.end() ? static_cast<unsigned int>(emptyPage - pages.begin()) : evictPage();
+        page = &pages[currentPage];
+    }
+
+    int x = page->penX, y = page->penY;
+    page->penX += w + glyphPadding;
+    page->rowHeight = std::max(page->rowHeight, h);
+    page->lastUsed = ++useClock;
+    page->empty = false;
+
+    // The glyph is uploaded with its padding, since an evicted page still holds the old glyphs' pixels
+    int paddedW = w + 2 * glyphPadding, paddedH = h + 2 * glyphPadding;
+    std::vector<unsigned char> pixels(paddedW * paddedH, 0);
+    for (int row = 0; row < h; ++row)
+        std::copy_n(glyph.pixels.begin() + row * w, w, pixels.begin() + (row + glyphPadding) * paddedW + glyphPadding);
+
+    // this can happen in the middle of drawing, so leave whatever texture is bound as it was
+    if (atlasTexture != 0) {
+        GLint boundTexture = 0;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D_ARRAY, &boundTexture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, atlasTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, x - glyphPadding, y - glyphPadding, static_cast<GLint>(currentPage),
+                        paddedW, paddedH, 1, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+        glBindTexture(GL_TEXTURE_2D_ARRAY, boundTexture);
+    }
+    for (int row = 0; row < paddedH; ++row)
+        std::copy_n(pixels.begin() + row * paddedW, paddedW,
+                    atlasPixels.begin() + (size_t(currentPage) * pageHeight + y - glyphPadding + row) * atlasWidth
+                    + x - glyphPadding);
+
+    Character &character = glyph.character;
+    character.UV = glm::vec4(float(x) / atlasWidth, float(y) / pageHeight,
+                             float(x + w) / atlasWidth, float(y + h) / pageHeight);
+    character.Page = currentPage;
+    return Characters.insert(codepoint, character);
+}
+
+unsigned int Font::evictPage() {
+    auto oldest = std::min_element(pages.begin() + 1, pages.end(),
+                                   [](const Page &a, const Page &b) { return a.lastUsed < b.lastUsed; });
+    unsigned int evicted = static_cast<unsigned int>(oldest - pages.begin());
+
+    Characters.eraseIf([evicted](uint32_t, const Character &character) { return character.Page == evicted; });
+    *oldest = Page{glyphPadding, glyphPadding, 0, 0, true};
+    generation++;
+    return evicted;
+}
+
+void Font::createAtlas() {
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // disable byte-alignment restriction
+
+    // generate the atlas texture; only page 0 has content up front
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlasTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RED, atlasWidth, pageHeight, pageCount, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, atlasWidth, asciiRows, 1, GL_RED, GL_UNSIGNED_BYTE,
+                    atlasPixels.data());
+
+    // set texture options
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+std::string Font::getCachePath(const unsigned char *fontData, size_t fontBytes, unsigned int pixelSize, FontMode mode) {
+    // everything that changes the atlas goes into the key
+    uint64_t key = fnv1a(fontData, fontBytes);
+    const uint32_t parameters[] = {pixelSize, static_cast<uint32_t>(mode), sdfRasterSize, sdfSpread,
+                                   atlasWidth, pageHeight, glyphPadding, cacheVersion};
+    key = fnv1a(parameters, sizeof(parameters), key);
+
+    char name[64];
+    snprintf(name, sizeof(name), "font-%016llx.bin", static_cast<unsigned long long>(key));
+    return cacheDirectory() + "/" + name;
+}
+
+bool Font::loadCache(const std::string &cachePath) {
+    PROFILE_ZONE("Font::loadCache");
+    MappedFile file;
+    if (!file.open(cachePath) || file.size() < sizeof(CacheHeader))
+        return false;
+
+    CacheHeader header{};
+    std::memcpy(&header, file.data(), sizeof(header));
+    size_t glyphBytes = header.glyphCount * sizeof(CachedGlyph);
+    size_t atlasBytes = size_t(header.atlasWidth) * header.rows;
+    if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion
+        || header.atlasWidth != atlasWidth || header.rows > pageHeight
+        || file.size() != sizeof(header) + glyphBytes + atlasBytes) {
+        std::cout << "ERROR::FONT: Ignoring invalid font cache " << cachePath << std::endl;
+        return false;
+    }
+
+    const unsigned char *glyphs = file.data() + sizeof(header);
+    for (uint32_t i = 0; i < header.glyphCount; i++) {
+        CachedGlyph glyph{};
+        std::memcpy(&glyph, glyphs + i * sizeof(CachedGlyph), sizeof(CachedGlyph));
+        Characters.insert(glyph.code, glyph.character);
+    }
+    scale = header.scale;
+
+    asciiRows = static_cast<int>(header.rows);
+    std::copy_n(glyphs + glyphBytes, atlasBytes, atlasPixels.begin());
+    return true;
+}
+
+void Font::saveCache(const std::string &cachePath, const std::vector<unsigned char> &atlas, int rows) const {
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory(), error);
+
+    // write to a temporary file first, so an interrupted write never leaves a broken cache behind
+    std::string tempPath = cachePath + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary);
+    if (!out) {
+        std::cout << "ERROR::FONT: Failed to write font cache " << cachePath << std::endl;
+        return;
+    }
+
+    CacheHeader header{};
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = cacheVersion;
+    header.atlasWidth = atlasWidth;
+    header.rows = static_cast<uint32_t>(rows);
+    header.glyphCount = static_cast<uint32_t>(Characters.size());
+    header.scale = scale;
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    // only page 0 exists at this point
+    Characters.forEach([&out](uint32_t codepoint, const Character &character) {
+        CachedGlyph glyph{codepoint, character};
+        out.write(reinterpret_cast<const char *>(&glyph), sizeof(glyph));
+    });
+    out.write(reinterpret_cast<const char *>(atlas.data()), static_cast<std::streamsize>(atlas.size()));
+    out.close();
+
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        std::cout << "ERROR::FONT: Failed to write font cache " << cachePath << std::endl;
+    }
+}
+
+const unsigned char *Font::getAtlasPixels(unsigned int page) const {
+    return atlasPixels.data() + size_t(page) * atlasWidth * pageHeight;
+}
+
+unsigned int Font::getAtlasTexture() const {
+    return atlasTexture;
+}
+
+unsigned int Font::getGeneration() const {
+    return generation;
+}
+
+float Font::getScale() const {
+    return scale;
+}
+
+FontMode Font::getMode() const {
+    return mode;
 }
@@ -1,8 +1,10 @@
 #ifndef GRAPHICS_FONT_H
 #define GRAPHICS_FONT_H
 
-#include <map>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 
 #include <glm/glm.hpp>
@@ -10,50 +12,273 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include "glyphMap.h"
+
 /**
  * @brief A single character
  * @details This struct is used to store information about a single character
  * 
- * @param TextureID ID handle of the glyph texture
+ * @param UV Top left (xy) and bottom right (zw) texture coordinates of the glyph in its atlas page
  * @param Size Size of glyph
  * @param Bearing Offset from baseline to left/top of glyph
  * @param Advance Offset to advance to next glyph
+ * @param Page The atlas page (texture array layer) the glyph is stored in
  */
 struct Character {
-    unsigned int TextureID;
+    glm::vec4    UV;
     glm::ivec2   Size;
     glm::ivec2   Bearing;
     unsigned int Advance;
+    unsigned int Page;
 };
 
+/**
+ * @brief How glyphs are stored in the atlas
+ * @details Bitmap stores coverage rasterized at the font size.
+ * SDF stores a signed distance field rasterized at Font::sdfRasterSize, which stays sharp at every scale
+ * and lets the shader draw outlines and glows.
+ */
+enum class FontMode { Bitmap, SDF };
+
 /**
  * @brief A font
- * @details This class is used to store information about a font
+ * @details This class is used to store information about a font.
+ * Glyphs live in a GL_TEXTURE_2D_ARRAY atlas whose layers are pages. Page 0 holds ASCII 0-127, is loaded up
+ * front (from the on-disk cache when possible) and never changes. Any other codepoint is rasterized the first
+ * time it is asked for into one of the remaining pages; when they are all full the least recently used page
+ * is emptied and reused. A single frame should not use more non-ASCII glyphs than those pages hold, or glyphs
+ * laid out earlier in the frame are overwritten before they are drawn.
  */
 class Font {
     public:
         /**
          * @brief Construct a new Font object
+         * @details The ASCII page and its metrics are loaded from the on-disk cache when a cache file exists for
+         * this font file, size and mode. FreeType is only used on a miss, and the result is written to the cache.
+         * No OpenGL calls are made, so the font can be loaded on a worker thread while the context is being
+         * created; call createAtlas() before drawing with it. Without createAtlas() the atlas only exists on the
+         * CPU (see getAtlasPixels()).
          * 
-         * @param fontPath The path to the font file
+         * @param fontName The font file's resource name, e.g. "fonts/MxPlus_IBM_BIOS.ttf" (see Resources)
          * @param fontSize The size of the font
+         * @param mode Whether to store coverage or a distance field
          */
-        Font(std::string fontPath, unsigned int fontSize);
+        Font(std::string_view fontName, unsigned int fontSize, FontMode mode = FontMode::Bitmap);
 
-        
         /**
-         * @brief Get the characters
-         * 
-         * @return a map of characters
+         * @brief Destroy the Font object
+         * @details Closes FreeType if glyphs were rasterized; the atlas texture is left to its owner
+         */
+        ~Font();
+
+        Font(const Font &) = delete;
+        Font &operator=(const Font &) = delete;
+
+        /**
+         * @brief Creates the atlas texture and uploads the ASCII page
+         * @details Call once, on the thread that owns the OpenGL context.
+         */
+        void createAtlas();
+
+        /**
+         * @brief Get a character, rasterizing it into the atlas the first time it is used
+         * @details Marks the character's page as used for the LRU eviction.
+         *
+         * @param codepoint The Unicode codepoint
+         * @return The character (characters the font lacks get the font's missing glyph)
+         */
+        const Character &getGlyph(uint32_t codepoint);
+
+        /**
+         * @brief Get the atlas texture holding every glyph (a GL_TEXTURE_2D_ARRAY)
+         * @details The texture is owned by whoever draws with it (see FontRenderer).
+         */
+        unsigned int getAtlasTexture() const;
+
+        /**
+         * @brief Get the number of atlas pages evicted so far
+         * @details Quads laid out before an eviction may point at glyphs that are gone,
+         * so cached layouts are redone when this changes.
+         */
+        unsigned int getGeneration() const;
+
+        /**
+         * @brief Get the factor from the stored glyph metrics to the requested font size
+         * @details 1 for bitmap fonts; SDF glyphs are rasterized at sdfRasterSize and scaled down.
+         */
+        float getScale() const;
+
+        /**
+         * @brief Get whether the atlas stores coverage or a distance field
+         */
+        FontMode getMode() const;
+
+        /**
+         * @brief Pixel size SDF glyphs are rasterized at, whatever size is requested
          */
-        std::map<char, Character> getCharacters() const;
+        static const unsigned int sdfRasterSize = 48;
+
+        /**
+         * @brief Distance in raster pixels covered by the SDF on each side of the glyph edge
+         */
+        static const int sdfSpread = 8;
+
+        /**
+         * @brief Width and height of an atlas page in pixels
+         */
+        static const int atlasWidth = 512;
+        static const int pageHeight = 1024;
+
+        /**
+         * @brief Number of atlas pages: the ASCII page and the pages filled on demand
+         */
+        static const int pageCount = 4;
+
+        /**
+         * @brief Get a CPU copy of an atlas page, atlasWidth bytes per row, top row first
+         * @details Kept in sync with the texture, for drawing text without the GPU (see SoftwareRenderer).
+         */
+        const unsigned char *getAtlasPixels(unsigned int page) const;
 
     private:
         /**
-         * @brief A set of character structs mapped to their ASCII character representations
+         * @brief A glyph rasterized by FreeType, before it is placed in the atlas
+         */
+        struct Bitmap {
+            uint32_t codepoint;
+            int x, y;
+            std::vector<unsigned char> pixels;
+            Character character;
+        };
+
+        /**
+         * @brief Shelf packing state and LRU stamp of an atlas page
          */
-        std::map<char, Character> Characters;
+        struct Page {
+            int penX, penY, rowHeight;
+            uint64_t lastUsed;
+            bool empty;
+        };
 
+        /**
+         * @brief Every loaded character, keyed by codepoint
+         */
+        GlyphMap<Character> Characters;
+
+        /**
+         * @brief The atlas texture
+         */
+        unsigned int atlasTexture = 0;
+
+        /**
+         * @brief See getScale()
+         */
+        float scale = 1.0f;
+
+        /**
+         * @brief The font file, embedded in the binary; FreeType reads the face straight from it
+         */
+        std::string_view fontData;
+        unsigned int fontSize;
+        FontMode mode;
+
+        /**
+         * @brief FreeType handles, opened the first time a glyph has to be rasterized
+         */
+        FT_Library ft = nullptr;
+        FT_Face face = nullptr;
+
+        std::vector<Page> pages;
+
+        /**
+         * @brief Incremented on every lookup of a glyph outside page 0; pages remember when they were last used
+         */
+        uint64_t useClock = 0;
+
+        /**
+         * @brief The page new glyphs are packed into
+         */
+        unsigned int currentPage = 1;
+
+        /**
+         * @brief See getGeneration()
+         */
+        unsigned int generation = 0;
+
+        /**
+         * @brief See getAtlasPixels(); pageCount pages of atlasWidth x pageHeight bytes
+         */
+        std::vector<unsigned char> atlasPixels;
+
+        /**
+         * @brief Rows of page 0 the ASCII glyphs take up, uploaded by createAtlas()
+         */
+        int asciiRows = 0;
+
+        /**
+         * @brief Empty pixels around each glyph so linear filtering does not bleed between glyphs
+         */
+        static const int glyphPadding = 1;
+
+        /**
+         * @brief Most threads the ASCII glyphs are rasterized on
+         */
+        static const unsigned int maxRasterThreads = 8;
+
+        /**
+         * @brief Initializes FreeType and loads the face, if not done yet
+         * @return false if the font could not be loaded
+         */
+        bool openFace();
+
+        /**
+         * @brief Initializes a FreeType library and loads the face into it, set up for this size and mode
+         * @return false if the font could not be loaded; nothing is left to free then
+         */
+        bool createFace(FT_Library &library, FT_Face &newFace) const;
+
+        /**
+         * @brief Rasterizes a single glyph (as a distance field in SDF mode)
+         * @param glyphFace The face to rasterize with; only one thread may use a face at a time
+         * @return false if FreeType failed to load the glyph
+         */
+        bool renderGlyph(FT_Face glyphFace, uint32_t codepoint, Bitmap &bitmap) const;
+
+        /**
+         * @brief Rasterizes the first 128 characters and packs them into page 0
+         * @details The glyphs are spread over up to maxRasterThreads threads, each with its own face; they are
+         * packed in codepoint order afterwards, so the page is the same however many threads there are.
+         *
+         * @param atlas Receives the pixels of the page, atlasWidth bytes per row
+         * @return The number of rows used
+         */
+        int rasterizeAscii(std::vector<unsigned char> &atlas);
+
+        /**
+         * @brief Rasterizes a glyph on demand and copies it into a page with room for it
+         */
+        const Character &loadGlyph(uint32_t codepoint);
+
+        /**
+         * @brief Empties the least recently used page (never page 0) and returns it
+         */
+        unsigned int evictPage();
+
+        /**
+         * @brief Builds the cache file name from a hash of the font file and everything else that affects the atlas
+         */
+        static std::string getCachePath(const unsigned char *fontData, size_t fontBytes, unsigned int pixelSize, FontMode mode);
+
+        /**
+         * @brief Memory-maps a cache file and loads page 0 from it
+         * @return false if the file does not exist or does not match this build
+         */
+        bool loadCache(const std::string &cachePath);
+
+        /**
+         * @brief Writes page 0 to a cache file
+         */
+        void saveCache(const std::string &cachePath, const std::vector<unsigned char> &atlas, int rows) const;
 };
 
 #endif //GRAPHICS_FONT_H
@@ -3,72 +3,192 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
-FontRenderer::FontRenderer(Shader& shader, std::string fontPath, int fontSize) {
+#include <algorithm>
+
+#include "../util/utf8.h"
+#include "../framework/allocationTracker.h"
+#include "../framework/profiler.h"
+
+FontRenderer::FontRenderer(Shader& shader, StreamBuffer& streamBuffer, std::string_view fontName, int fontSize,
+                           FontMode mode)
+    : FontRenderer(shader, streamBuffer, std::make_unique<Font>(fontName, fontSize, mode)) {
+}
+
+FontRenderer::FontRenderer(Shader& shader, StreamBuffer& streamBuffer, std::unique_ptr<Font> font)
+    : FontRenderer(std::move(font)) {
     this->shader = shader;
+    this->streamBuffer = &streamBuffer;
     this->initRenderData();
-    Font myFont(fontPath, fontSize);
-    this->font = myFont.getCharacters();
+    this->font->createAtlas();
+    this->atlasTexture = this->font->getAtlasTexture();
+
+    if (mode == FontMode::SDF) {
+        setOutline(0.0f, glm::vec4(0.0f));
+        setGlow(0.0f, glm::vec4(0.0f));
+    }
+}
+
+FontRenderer::FontRenderer(std::unique_ptr<Font> font)
+    : font(std::move(font)), mode(this->font->getMode()) {
+    this->fontScale = this->font->getScale();
 }
 
 FontRenderer::~FontRenderer() {
+    if (isLayoutOnly())
+        return;
     glDeleteVertexArrays(1, &this->VAO);
-    glDeleteBuffers(1, &this->VBO);
+    glDeleteTextures(1, &this->atlasTexture);
 }
 
 void FontRenderer::initRenderData() {
+    // Glyph quads are streamed, so the attributes point at the start of the stream buffer
+    // and each draw selects its vertices with the first vertex index
     glGenVertexArrays(1, &this->VAO);
-    glGenBuffers(1, &this->VBO);
     glBindVertexArray(this->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
+    glBindBuffer(GL_ARRAY_BUFFER, streamBuffer->getBuffer());
+    setVertexAttributes();
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
 
-void FontRenderer::renderText(std::string text, float x, float y, const glm::mat4 projection, float scale, glm::vec3 color) {
-    // activate corresponding render state
+void FontRenderer::setVertexAttributes() {
+    // <vec2 pos, vec2 tex>
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphVertex), (void*)offsetof(GlyphVertex, x));
+    // color, normalized from 0-255
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(GlyphVertex), (void*)offsetof(GlyphVertex, color));
+    // atlas page (texture array layer)
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(GlyphVertex), (void*)offsetof(GlyphVertex, page));
+}
 
+void FontRenderer::renderText(std::string_view text, float x, float y, float scale, glm::vec3 color) {
+    begin();
+    draw(text.data(), text.length(), x, y, scale, color);
+    end();
+}
+
+void FontRenderer::begin() {
+    // activate corresponding render state
     this->shader.use();
-    glUniformMatrix4fv(glGetUniformLocation(this->shader.ID, "projection"), 1, false, glm::value_ptr(projection));
-    glUniform3f(glGetUniformLocation(this->shader.ID, "textColor"), color.x, color.y, color.z);
 
     glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(this->VAO);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, this->atlasTexture);
+    glStats.stateChanges += 2;
+
+    batch.clear();
+}
+
+void FontRenderer::draw(const char *text, size_t length, float x, float y, float scale, glm::vec3 color) {
+    layout(text, length, x, y, scale, color, batch);
+}
+
+void FontRenderer::layout(const char *text, size_t length, float x, float y, float scale, glm::vec3 color,
+                          std::vector<GlyphVertex> &out) {
+    PROFILE_ZONE("FontRenderer::layout");
+    ALLOCATION_SCOPE("Text");
+    const unsigned char r = static_cast<unsigned char>(color.x * 255.0f + 0.5f);
+    const unsigned char g = static_cast<unsigned char>(color.y * 255.0f + 0.5f);
+    const unsigned char b = static_cast<unsigned char>(color.z * 255.0f + 0.5f);
+    // glyph metrics are stored at the raster size
+    scale *= fontScale;
 
     // iterate through all characters
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++) {
-        Character ch = font[*c];
+    for (const char *c = text, *end = text + length; c != end;) {
+        const Character &ch = font->getGlyph(nextCodepoint(c, end));
+        const float page = static_cast<float>(ch.Page);
 
         float xpos = x + ch.Bearing.x * scale;
         float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
 
         float w = ch.Size.x * scale;
         float h = ch.Size.y * scale;
-        // update VBO for each character
-        float vertices[6][4] = {
-            { xpos,     ypos + h,   0.0f, 0.0f },            
-            { xpos,     ypos,       0.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-            { xpos + w, ypos + h,   1.0f, 0.0f }           
+
+        // the atlas stores glyphs top row first, so the top of the quad gets the smaller v
+        float u0 = ch.UV.x, v0 = ch.UV.y, u1 = ch.UV.z, v1 = ch.UV.w;
+        GlyphVertex vertices[6] = {
+            { xpos,     ypos + h,   u0, v0, {r, g, b, 255}, page },
+            { xpos,     ypos,       u0, v1, {r, g, b, 255}, page },
+            { xpos + w, ypos,       u1, v1, {r, g, b, 255}, page },
+
+            { xpos,     ypos + h,   u0, v0, {r, g, b, 255}, page },
+            { xpos + w, ypos,       u1, v1, {r, g, b, 255}, page },
+            { xpos + w, ypos + h,   u1, v0, {r, g, b, 255}, page }
         };
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        out.insert(out.end(), vertices, vertices + 6);
+
         // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
         x += (ch.Advance >> 6) * scale; // bitshift by 6 to get value in pixels (2^6 = 64)
     }
+}
+
+float FontRenderer::measure(const char *text, size_t length, float scale) {
+    unsigned int advance = 0;
+    for (const char *c = text, *end = text + length; c != end;)
+        advance += font->getGlyph(nextCodepoint(c, end)).Advance >> 6;
+    return advance * scale * fontScale;
+}
+
+void FontRenderer::setOutline(float width, glm::vec4 color) {
+    if (mode != FontMode::SDF || isLayoutOnly())
+        return;
+    // pixels at the font size -> raster pixels -> distance field units (0.5 is the glyph edge);
+    // the field only reaches sdfSpread raster pixels past the edge, the quad ends there
+    float distance = std::min(width / fontScale / (2.0f * Font::sdfSpread), 0.5f);
+    shader.use();
+    shader.setFloat("outlineWidth", distance);
+    shader.setVector4f("outlineColor", color);
+}
+
+void FontRenderer::setGlow(float width, glm::vec4 color) {
+    if (mode != FontMode::SDF || isLayoutOnly())
+        return;
+    float distance = std::min(width / fontScale / (2.0f * Font::sdfSpread), 0.5f);
+    shader.use();
+    shader.setFloat("glowWidth", distance);
+    shader.setVector4f("glowColor", color);
+}
+
+void FontRenderer::end() {
+    if (!batch.empty()) {
+        // every quad collected since begin() goes out in one upload and one draw call
+        // (cached TextLayouts may have bound their own VAO since begin())
+        glBindVertexArray(this->VAO);
+        glStats.stateChanges++;
+        const GLsizeiptr stride = sizeof(GlyphVertex);
+        GLintptr offset = streamBuffer->upload(batch.data(), batch.size() * stride, stride);
+        if (offset >= 0) {
+            glDrawArrays(GL_TRIANGLES, static_cast<GLint>(offset / stride), static_cast<GLsizei>(batch.size()));
+            glStats.drawCalls++;
+        }
+    }
 
     glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glStats.stateChanges += 2;
+}
+
+const Shader &FontRenderer::getShader() const {
+    return shader;
+}
+
+GLuint FontRenderer::getAtlasTexture() const {
+    return atlasTexture;
+}
+
+unsigned int FontRenderer::getAtlasGeneration() const {
+    return font->getGeneration();
+}
+
+FontMode FontRenderer::getMode() const {
+    return mode;
+}
+
+const Font &FontRenderer::getFont() const {
+    return *font;
+}
+
+bool FontRenderer::isLayoutOnly() const {
+    return streamBuffer == nullptr;
 }
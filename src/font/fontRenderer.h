@@ -3,11 +3,27 @@
 
 #include "../framework/shaderManager.h"
 #include "../framework/shader.h"
+#include "../framework/streamBuffer.h"
 #include "font.h"
 
+#include <memory>
+#include <string_view>
+
+/**
+ * @brief A vertex of a glyph quad
+ * @details Position and atlas texture coordinates, plus the text color so runs of different colors share a draw call,
+ * and the atlas page the glyph is on.
+ */
+struct GlyphVertex {
+    float x, y, u, v;
+    unsigned char color[4];
+    float page;
+};
+
 /**
  * @brief A font renderer
- * @details This class is used to render text using a font
+ * @details This class is used to render text using a font.
+ * Glyph quads are collected between begin() and end() and drawn with a single draw call from the font's atlas.
  */
 class FontRenderer {
     public:
@@ -16,28 +32,153 @@ class FontRenderer {
          * @details This constructor will call the font constructor and initialize the render data
          * 
          * @param shader The shader to use
-         * @param fontPath The path to the font file
-         * @param fontSize The size of the font
+         * @param streamBuffer The buffer glyph quads are streamed through every frame
+         * @param fontName The font file's resource name
+         * @param fontSize The size of the font; a text scale of 1 draws glyphs at this size
+         * @param mode Bitmap for the "text.frag" shader, SDF for "textSdf.frag"
          */
-        FontRenderer(Shader& shader, std::string fontPath, int fontSize);
+        FontRenderer(Shader& shader, StreamBuffer& streamBuffer, std::string_view fontName, int fontSize,
+                     FontMode mode = FontMode::Bitmap);
+
+        /**
+         * @brief Construct a new Font Renderer object from a font loaded beforehand
+         * @details E.g. on a worker thread while the context was created; its atlas texture is created here.
+         * 
+         * @param shader The shader to use
+         * @param streamBuffer The buffer glyph quads are streamed through every frame
+         * @param font The font, whose mode decides the shader as above
+         */
+        FontRenderer(Shader& shader, StreamBuffer& streamBuffer, std::unique_ptr<Font> font);
+
+        /**
+         * @brief Construct a Font Renderer that only lays text out, for drawing without an OpenGL context
+         * @details No VAO or atlas texture is created, so begin(), draw(), end() and renderText() must not be used.
+         * Glyphs still go into the font's CPU atlas, which the SoftwareRenderer reads.
+         *
+         * @param font The font
+         */
+        explicit FontRenderer(std::unique_ptr<Font> font);
 
         /**
          * @brief Destroy the Font Renderer object
-         * @details destroys the VAO and VBO associated with the font renderer
+         * @details destroys the VAO and atlas texture associated with the font renderer, if it has them
          */
         ~FontRenderer();
 
         /**
          * @brief Renders text on the screen
-         * 
+         * @details Draws the whole string with one draw call. The text is only read, so literals, std::string
+         * and FixedString buffers are all drawn without copying.
+         *
          * @param text The text to render
          * @param x The x position of the text
          * @param y The y position of the text
-         * @param projection The projection matrix
          * @param scale The scale of the text
          * @param color The color of the text
          */
-        void renderText(std::string text, float x, float y, const glm::mat4 projection, float scale, glm::vec3 color);
+        void renderText(std::string_view text, float x, float y, float scale, glm::vec3 color);
+
+        /**
+         * @brief Activates the text program, binds the atlas, and starts a new batch
+         * @details The Renderer uses begin(), draw() and end() to draw consecutive text runs with one draw call.
+         */
+        void begin();
+
+        /**
+         * @brief Adds a run of text to the batch started by begin()
+         *
+         * @param text The first character of the text
+         * @param length The number of characters to draw
+         * @param x The x position of the text
+         * @param y The y position of the text
+         * @param scale The scale of the text
+         * @param color The color of the text
+         */
+        void draw(const char *text, size_t length, float x, float y, float scale, glm::vec3 color);
+
+        /**
+         * @brief Uploads the batch, draws it, and unbinds the state bound by begin()
+         */
+        void end();
+
+        /**
+         * @brief Appends the glyph quads of a run of text to a vertex array
+         * @details Used by draw() for the per-frame batch and by TextLayout for cached text.
+         * Glyphs that are not in the atlas yet are rasterized into it.
+         *
+         * @param text The first byte of the UTF-8 text
+         * @param length The number of bytes
+         * @param x The x position of the text
+         * @param y The y position of the text
+         * @param scale The scale of the text
+         * @param color The color of the text
+         * @param out The vertices are appended here
+         */
+        void layout(const char *text, size_t length, float x, float y, float scale, glm::vec3 color,
+                    std::vector<GlyphVertex> &out);
+
+        /**
+         * @brief Measures the width of a run of text from the glyph advances
+         *
+         * @param text The first byte of the UTF-8 text
+         * @param length The number of bytes
+         * @param scale The scale of the text
+         * @return The width in pixels
+         */
+        float measure(const char *text, size_t length, float scale);
+
+        /**
+         * @brief Draws an outline around every glyph (SDF fonts only)
+         *
+         * @param width The width of the outline in pixels at a text scale of 1; 0 disables it.
+         * Limited to the distance the field covers (Font::sdfSpread raster pixels).
+         * @param color The color of the outline
+         */
+        void setOutline(float width, glm::vec4 color);
+
+        /**
+         * @brief Draws a soft glow behind every glyph (SDF fonts only)
+         *
+         * @param width How far the glow reaches in pixels at a text scale of 1; 0 disables it.
+         * Limited like the outline width.
+         * @param color The color of the glow at the glyph edge
+         */
+        void setGlow(float width, glm::vec4 color);
+
+        /**
+         * @brief Sets up the GlyphVertex attributes on the currently bound VAO and GL_ARRAY_BUFFER
+         */
+        static void setVertexAttributes();
+
+        /**
+         * @brief Returns the text shader
+         */
+        const Shader &getShader() const;
+
+        /**
+         * @brief Returns the atlas texture all glyphs are drawn from (a GL_TEXTURE_2D_ARRAY)
+         */
+        GLuint getAtlasTexture() const;
+
+        /**
+         * @brief Returns a counter that changes whenever glyphs are evicted from the atlas (see Font::getGeneration())
+         */
+        unsigned int getAtlasGeneration() const;
+
+        /**
+         * @brief Returns how the atlas stores glyphs
+         */
+        FontMode getMode() const;
+
+        /**
+         * @brief Returns the font, for reading the atlas on the CPU (see Font::getAtlasPixels())
+         */
+        const Font &getFont() const;
+
+        /**
+         * @brief Returns true if the renderer was created without an OpenGL context and only lays text out
+         */
+        bool isLayoutOnly() const;
 
     private:
         /**
@@ -45,16 +186,44 @@ class FontRenderer {
          */
         Shader shader;
 
+
+        /**
+         * @brief The VAO associated with the font renderer
+         * @details Its vertex attribute reads from the stream buffer.
+         */
+        GLuint VAO = 0;
+
+        /**
+         * @brief Per-frame glyph quads are uploaded here (nullptr when the renderer only lays text out)
+         */
+        StreamBuffer *streamBuffer = nullptr;
+
         /**
-         * @brief The VAO and VBO associated with the font renderer
+         * @brief The font; holds the glyph metrics (its atlas texture is owned by the font renderer)
          */
-        GLuint VAO, VBO;
+        std::unique_ptr<Font> font;
 
         /**
-         * @brief A set of character structs mapped to their ASCII character representations
-         * @details This is the same map generated by the font class
+         * @brief The atlas texture of the font
          */
-        std::map<char, Character> font;
+        GLuint atlasTexture = 0;
+
+        /**
+         * @brief How the atlas stores glyphs
+         */
+        FontMode mode;
+
+        /**
+         * @brief Factor from the glyph metrics to the requested font size (see Font::getScale())
+         */
+        float fontScale;
+
+        /**
+         * @brief Glyph quads collected since begin()
+         * @details Cleared (not freed) by begin(), so steady-state frames do not allocate.
+         */
+        std::vector<GlyphVertex> batch;
+
 
         /**
          * @brief Initializes and configures the buffer and vertex attributes
@@ -0,0 +1,121 @@
+#ifndef GRAPHICS_GLYPHMAP_H
+#define GRAPHICS_GLYPHMAP_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Open-addressing hash table from codepoints to glyph data (Character)
+ * @details Slots live in one flat array and collisions are resolved by linear probing, so a lookup is a
+ * multiply, a mask and usually a single cache line. Entries are removed in bulk with eraseIf(), which
+ * rebuilds the table, because glyphs only ever leave when a whole atlas page is evicted.
+ */
+template<typename Value>
+class GlyphMap {
+    public:
+        GlyphMap() : slots(minimumCapacity) {}
+
+        /**
+         * @brief Finds a character
+         * @return The character, or nullptr if it is not in the table
+         */
+        const Value *find(uint32_t codepoint) const {
+            for (size_t i = slotOf(codepoint);; i = (i + 1) & (slots.size() - 1)) {
+                const Slot &slot = slots[i];
+                if (slot.codepoint == codepoint)
+                    return &slot.value;
+                if (slot.codepoint == emptyCodepoint)
+                    return nullptr;
+            }
+        }
+
+        /**
+         * @brief Adds a character that is not in the table yet
+         * @return The stored character
+         */
+        Value &insert(uint32_t codepoint, const Value &value) {
+            // keep the load below 3/4 so probe sequences stay short
+            if ((count + 1) * 4 > slots.size() * 3)
+                rehash(slots.size() * 2);
+            count++;
+            return place(codepoint, value);
+        }
+
+        /**
+         * @brief Removes every character the predicate returns true for
+         */
+        template<typename Predicate>
+        void eraseIf(Predicate remove) {
+            std::vector<Slot> old;
+            old.swap(slots);
+            slots.assign(old.size(), Slot{});
+            count = 0;
+            for (const Slot &slot : old) {
+                if (slot.codepoint != emptyCodepoint && !remove(slot.codepoint, slot.value)) {
+                    place(slot.codepoint, slot.value);
+                    count++;
+                }
+            }
+        }
+
+        /**
+         * @brief Calls f(codepoint, value) for every entry, in no particular order
+         */
+        template<typename Function>
+        void forEach(Function f) const {
+            for (const Slot &slot : slots) {
+                if (slot.codepoint != emptyCodepoint)
+                    f(slot.codepoint, slot.value);
+            }
+        }
+
+        /**
+         * @brief The number of characters in the table
+         */
+        size_t size() const { return count; }
+
+    private:
+        struct Slot {
+            uint32_t codepoint = emptyCodepoint;
+            Value value{};
+        };
+
+        /**
+         * @brief Marks an unused slot; not a valid codepoint
+         */
+        static const uint32_t emptyCodepoint = 0xFFFFFFFF;
+
+        /**
+         * @brief Enough for the preloaded ASCII set without growing; must be a power of two
+         */
+        static const size_t minimumCapacity = 256;
+
+        std::vector<Slot> slots;
+        size_t count = 0;
+
+        size_t slotOf(uint32_t codepoint) const {
+            // Fibonacci hashing spreads neighbouring codepoints across the table
+            return static_cast<size_t>((codepoint * 2654435769u) >> 8) & (slots.size() - 1);
+        }
+
+        Value &place(uint32_t codepoint, const Value &value) {
+            size_t i = slotOf(codepoint);
+            while (slots[i].codepoint != emptyCodepoint)
+                i = (i + 1) & (slots.size() - 1);
+            slots[i].codepoint = codepoint;
+            slots[i].value = value;
+            return slots[i].value;
+        }
+
+        void rehash(size_t capacity) {
+            std::vector<Slot> old;
+            old.swap(slots);
+            slots.assign(capacity, Slot{});
+            for (const Slot &slot : old) {
+                if (slot.codepoint != emptyCodepoint)
+                    place(slot.codepoint, slot.value);
+            }
+        }
+};
+
+#endif //GRAPHICS_GLYPHMAP_H
@@ -0,0 +1,90 @@
+#include "textLayout.h"
+
+#include "../framework/glStats.h"
+#include "../framework/allocationTracker.h"
+#include "../framework/profiler.h"
+
+TextLayout::TextLayout(FontRenderer &fontRenderer) : fontRenderer(fontRenderer) {
+    // without a context the quads are only kept on the CPU, for the SoftwareRenderer
+    if (fontRenderer.isLayoutOnly())
+        return;
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    FontRenderer::setVertexAttributes();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+TextLayout::~TextLayout() {
+    if (VAO == 0)
+        return;
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+}
+
+size_t TextLayout::addLine(std::string_view text, float x, float y, float scale, glm::vec3 color, TextAlign align) {
+    lines.push_back({std::string(text), x, y, scale, color, align});
+    dirty = true;
+    return lines.size() - 1;
+}
+
+void TextLayout::setText(size_t line, std::string_view text) {
+    std::string &current = lines[line].text;
+    if (current == text)
+        return;
+    current.assign(text.data(), text.size());
+    dirty = true;
+}
+
+void TextLayout::reserve(size_t glyphs) {
+    vertices.reserve(glyphs * 6);
+}
+
+float TextLayout::getWidth(size_t line) {
+    const Line &l = lines[line];
+    return fontRenderer.measure(l.text.data(), l.text.length(), l.scale);
+}
+
+void TextLayout::update() {
+    if (!dirty && generation == fontRenderer.getAtlasGeneration())
+        return;
+    PROFILE_ZONE("TextLayout::update");
+    ALLOCATION_SCOPE("Text");
+    const unsigned int before = fontRenderer.getAtlasGeneration();
+
+    vertices.clear();
+    for (size_t i = 0; i < lines.size(); i++) {
+        const Line &l = lines[i];
+        float x = l.x;
+        if (l.align == TextAlign::Center)
+            x -= getWidth(i) / 2.0f;
+        fontRenderer.layout(l.text.data(), l.text.length(), x, l.y, l.scale, l.color, vertices);
+    }
+    vertexCount = static_cast<GLsizei>(vertices.size());
+    // a page evicted by a later line may have held glyphs of an earlier one, so lay out again next frame
+    generation = fontRenderer.getAtlasGeneration();
+    dirty = generation != before;
+
+    if (VBO == 0)
+        return;
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GlyphVertex), vertices.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glStats.bufferUploads++;
+    glStats.stateChanges += 2;
+}
+
+void TextLayout::draw() const {
+    if (vertexCount == 0)
+        return;
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    glStats.stateChanges++;
+    glStats.drawCalls++;
+}
+
+const std::vector<GlyphVertex> &TextLayout::getVertices() const {
+    return vertices;
+}
@@ -0,0 +1,122 @@
+#ifndef GRAPHICS_TEXTLAYOUT_H
+#define GRAPHICS_TEXTLAYOUT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fontRenderer.h"
+
+/**
+ * @brief How the x position of a line in a TextLayout is interpreted
+ */
+enum class TextAlign { Left, Center };
+
+/**
+ * @brief A block of text lines whose glyph quads are laid out once and cached on the GPU
+ * @details Lines are measured with the real glyph advances. The quads are only laid out again when a
+ * line's text changes, so drawing a static block is one draw call with no CPU layout work.
+ */
+class TextLayout {
+    public:
+        /**
+         * @brief Construct a new, empty Text Layout object
+         *
+         * @param fontRenderer The renderer whose font and atlas the text uses
+         */
+        explicit TextLayout(FontRenderer &fontRenderer);
+
+        /**
+         * @brief Destroy the Text Layout object
+         * @details destroys the VAO and VBO holding the cached quads, if it has them
+         */
+        ~TextLayout();
+
+        TextLayout(const TextLayout &) = delete;
+        TextLayout &operator=(const TextLayout &) = delete;
+
+        /**
+         * @brief Adds a line of text to the block
+         *
+         * @param text The text to display
+         * @param x The x position (left edge or center, depending on align)
+         * @param y The y position of the baseline
+         * @param scale The scale of the text
+         * @param color The color of the text
+         * @param align How x is interpreted
+         * @return The index of the line, for setText()
+         */
+        size_t addLine(std::string_view text, float x, float y, float scale, glm::vec3 color,
+                       TextAlign align = TextAlign::Left);
+
+        /**
+         * @brief Changes the text of a line; the block is laid out again only if it differs
+         * @details Reuses the line's storage, so text that fits in it is set without allocating.
+         */
+        void setText(size_t line, std::string_view text);
+
+        /**
+         * @brief Makes room for this many glyphs, so laying out up to that many does not allocate
+         */
+        void reserve(size_t glyphs);
+
+        /**
+         * @brief Returns the width of a line in pixels
+         */
+        float getWidth(size_t line);
+
+        /**
+         * @brief Lays the block out again and uploads the quads if anything changed or atlas pages were evicted
+         * @details Called by the Renderer when the layout is submitted.
+         */
+        void update();
+
+        /**
+         * @brief Draws the cached quads, assuming FontRenderer::begin() has been called
+         */
+        void draw() const;
+
+        /**
+         * @brief Returns the cached quads, 6 vertices per glyph, as of the last update()
+         */
+        const std::vector<GlyphVertex> &getVertices() const;
+
+    private:
+        struct Line {
+            std::string text;
+            float x, y, scale;
+            glm::vec3 color;
+            TextAlign align;
+        };
+
+        FontRenderer &fontRenderer;
+
+        std::vector<Line> lines;
+
+        /**
+         * @brief True if the cached quads no longer match the lines
+         */
+        bool dirty = true;
+
+        /**
+         * @brief The atlas generation the quads were laid out in; an eviction since then may have moved glyphs
+         */
+        unsigned int generation = 0;
+
+        /**
+         * @brief The VAO and VBO holding the cached quads; 0 if the font renderer only lays text out
+         */
+        GLuint VAO = 0, VBO = 0;
+
+        /**
+         * @brief The number of vertices in the VBO
+         */
+        GLsizei vertexCount = 0;
+
+        /**
+         * @brief CPU copy of the quads, reused between layouts
+         */
+        std::vector<GlyphVertex> vertices;
+};
+
+#endif //GRAPHICS_TEXTLAYOUT_H
@@ -0,0 +1,152 @@
+#include "allocationTracker.h"
+
+#ifdef ENABLE_ALLOCATION_TRACKING
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <new>
+
+namespace {
+    /// @brief Allocations of one thread, in total and per scope
+    /// @details Plain data with constant initialization, so operator new can use it on any thread at any
+    /// time, including before main() and while the thread is being set up.
+    struct ThreadCounters {
+        long allocations;
+        long bytes;
+        long scopeAllocations[AllocationTracker::maxScopes];
+        long scopeBytes[AllocationTracker::maxScopes];
+    };
+
+    thread_local ThreadCounters counters;
+    thread_local ThreadCounters lastFrame;
+    thread_local int currentScope = 0;
+
+    std::mutex scopeMutex;
+    /// @brief Scope names by id; id 0 collects allocations outside any scope
+    const char *scopeNames[AllocationTracker::maxScopes] = {"other"};
+    std::atomic<int> scopeCount{1};
+
+    void count(std::size_t size) {
+        counters.allocations++;
+        counters.bytes += static_cast<long>(size);
+        counters.scopeAllocations[currentScope]++;
+        counters.scopeBytes[currentScope] += static_cast<long>(size);
+    }
+
+    void *allocate(std::size_t size) {
+        count(size);
+        void *memory = std::malloc(size ? size : 1);
+        if (!memory)
+            throw std::bad_alloc();
+        return memory;
+    }
+
+    void *allocateAligned(std::size_t size, std::align_val_t alignment) {
+        count(size);
+        std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+        void *memory = _aligned_malloc(size ? size : 1, align);
+#else
+        // aligned_alloc wants a multiple of the alignment
+        void *memory = std::aligned_alloc(align, ((size ? size : 1) + align - 1) / align * align);
+#endif
+        if (!memory)
+            throw std::bad_alloc();
+        return memory;
+    }
+
+    void freeAligned(void *memory) {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+}
+
+AllocationCounts AllocationTracker::nextFrame() {
+    lastFrame = counters;
+    counters = ThreadCounters();
+    return {lastFrame.allocations, lastFrame.bytes};
+}
+
+void AllocationTracker::printLastFrame() {
+    // printing allocates too, which should not count against the next frame
+    const ThreadCounters saved = counters;
+    const int scopes = scopeCount.load(std::memory_order_acquire);
+    std::cout << "Allocations last frame: " << lastFrame.allocations << " (" << lastFrame.bytes << " bytes)\n";
+    for (int scope = 0; scope < scopes; ++scope) {
+        if (lastFrame.scopeAllocations[scope] == 0)
+            continue;
+        std::cout << "  " << std::left << std::setw(24) << scopeNames[scope] << std::right
+                  << std::setw(8) << lastFrame.scopeAllocations[scope]
+                  << std::setw(12) << lastFrame.scopeBytes[scope] << " bytes\n";
+    }
+    std::cout << std::flush;
+    counters = saved;
+}
+
+int AllocationTracker::registerScope(const char *name) {
+    std::lock_guard<std::mutex> lock(scopeMutex);
+    const int scopes = scopeCount.load(std::memory_order_relaxed);
+    for (int scope = 0; scope < scopes; ++scope) {
+        if (std::strcmp(scopeNames[scope], name) == 0)
+            return scope;
+    }
+    if (scopes == maxScopes) {
+        std::cout << "ERROR::ALLOCATION: Too many scopes, counting " << name << " as other" << std::endl;
+        return 0;
+    }
+    scopeNames[scopes] = name;
+    scopeCount.store(scopes + 1, std::memory_order_release);
+    return scopes;
+}
+
+int AllocationTracker::enterScope(int scope) {
+    int previous = currentScope;
+    currentScope = scope;
+    return previous;
+}
+
+void AllocationTracker::leaveScope(int previous) {
+    currentScope = previous;
+}
+
+// Replacements for every global allocation function; the deallocation functions only need to match them
+void *operator new(std::size_t size) { return allocate(size); }
+void *operator new[](std::size_t size) { return allocate(size); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    try { return allocate(size); } catch (const std::bad_alloc &) { return nullptr; }
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    try { return allocate(size); } catch (const std::bad_alloc &) { return nullptr; }
+}
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    try { return allocateAligned(size, alignment); } catch (const std::bad_alloc &) { return nullptr; }
+}
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    try { return allocateAligned(size, alignment); } catch (const std::bad_alloc &) { return nullptr; }
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete[](void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+
+void operator delete(void *memory, std::align_val_t) noexcept { freeAligned(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { freeAligned(memory); }
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { freeAligned(memory); }
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept { freeAligned(memory); }
+void operator delete(void *memory, std::align_val_t, const std::nothrow_t &) noexcept { freeAligned(memory); }
+void operator delete[](void *memory, std::align_val_t, const std::nothrow_t &) noexcept { freeAligned(memory); }
+
+#endif
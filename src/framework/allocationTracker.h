@@ -0,0 +1,80 @@
+#ifndef GRAPHICS_ALLOCATIONTRACKER_H
+#define GRAPHICS_ALLOCATIONTRACKER_H
+
+/// @brief Heap allocations and the bytes they requested
+struct AllocationCounts {
+    long allocations = 0;
+    long bytes = 0;
+};
+
+/// @brief Counts heap allocations per frame and per subsystem.
+/// @details Replaces the global operator new, so every allocation is counted, including those made inside
+/// the standard library. Counts are kept per thread; nextFrame() reports those of the calling thread.
+/// Code is attributed to a subsystem with ALLOCATION_SCOPE("Name") until the end of the enclosing scope;
+/// allocations outside any scope are reported as "other".
+///
+/// Built when ENABLE_ALLOCATION_TRACKING is defined (the TRACK_ALLOCATIONS CMake option). Without it
+/// operator new is left alone, ALLOCATION_SCOPE expands to nothing and the counts are always zero.
+class AllocationTracker {
+public:
+#ifdef ENABLE_ALLOCATION_TRACKING
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    /// @brief Upper bound on the number of distinct scope names
+    static const int maxScopes = 32;
+
+    /// @brief Ends the calling thread's frame
+    /// @return The allocations the thread made since the last call
+    static AllocationCounts nextFrame();
+
+    /// @brief Prints the allocations of the frame last ended by nextFrame(), per subsystem
+    static void printLastFrame();
+
+    /// @brief Returns the id of a scope name, registering it on first use; used by ALLOCATION_SCOPE
+    /// @param name A string literal
+    static int registerScope(const char *name);
+
+    /// @brief Attributes the calling thread's allocations to a scope
+    /// @return The scope that was active before, to pass back to leaveScope()
+    static int enterScope(int scope);
+    static void leaveScope(int previous);
+};
+
+#ifdef ENABLE_ALLOCATION_TRACKING
+
+/// @brief Attributes the allocations between its construction and destruction to a scope
+class AllocationScope {
+public:
+    explicit AllocationScope(int scope) : previous(AllocationTracker::enterScope(scope)) {}
+    ~AllocationScope() { AllocationTracker::leaveScope(previous); }
+
+    AllocationScope(const AllocationScope &) = delete;
+    AllocationScope &operator=(const AllocationScope &) = delete;
+
+private:
+    int previous;
+};
+
+#define ALLOCATION_CONCAT_INNER(a, b) a##b
+#define ALLOCATION_CONCAT(a, b) ALLOCATION_CONCAT_INNER(a, b)
+/// @brief Attributes the rest of the enclosing scope's allocations to a subsystem; name must be a string literal
+#define ALLOCATION_SCOPE(name)                                                                                    \
+    static const int ALLOCATION_CONCAT(allocationScopeId, __LINE__) = AllocationTracker::registerScope(name);    \
+    AllocationScope ALLOCATION_CONCAT(allocationScope, __LINE__)(ALLOCATION_CONCAT(allocationScopeId, __LINE__))
+
+#else
+
+#define ALLOCATION_SCOPE(name) ((void)0)
+
+inline AllocationCounts AllocationTracker::nextFrame() { return {}; }
+inline void AllocationTracker::printLastFrame() {}
+inline int AllocationTracker::registerScope(const char *) { return 0; }
+inline int AllocationTracker::enterScope(int) { return 0; }
+inline void AllocationTracker::leaveScope(int) {}
+
+#endif
+
+#endif //GRAPHICS_ALLOCATIONTRACKER_H
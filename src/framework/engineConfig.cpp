@@ -0,0 +1,129 @@
+#include "engineConfig.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    /// @brief Parses a whole string as a number, or returns false
+    bool parseNumber(const char *text, double &value) {
+        char *end = nullptr;
+        value = std::strtod(text, &end);
+        return end != text && *end == '\0';
+    }
+}
+
+EngineConfig EngineConfig::parse(int argc, char *argv[]) {
+    EngineConfig config;
+    bool framesGiven = false;
+    bool deltaTimeGiven = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *option = argv[i];
+        // every option but --headless, --software and --hud takes a value
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        double number = 0;
+
+        if (std::strcmp(option, "--headless") == 0) {
+            config.headless = true;
+            continue;
+        }
+        if (std::strcmp(option, "--software") == 0) {
+            config.software = true;
+            continue;
+        }
+        if (std::strcmp(option, "--hud") == 0) {
+            config.showHud = true;
+            continue;
+        }
+        if (std::strcmp(option, "--help") == 0) {
+            config.valid = false;
+            break;
+        }
+        bool known = std::strcmp(option, "--frames") == 0 || std::strcmp(option, "--fixed-dt") == 0
+                  || std::strcmp(option, "--capture") == 0 || std::strcmp(option, "--capture-every") == 0 || std::strcmp(option, "--record") == 0
+                  || std::strcmp(option, "--record-format") == 0 || std::strcmp(option, "--record-pipe") == 0
+                  || std::strcmp(option, "--trace") == 0 || std::strcmp(option, "--alloc-gate") == 0
+                  || std::strcmp(option, "--benchmark") == 0 || std::strcmp(option, "--resources") == 0;
+        if (!known) {
+            std::cout << "ERROR::CONFIG: Unknown option " << option << std::endl;
+            config.valid = false;
+            break;
+        }
+        if (!value) {
+            std::cout << "ERROR::CONFIG: Missing value for " << option << std::endl;
+            config.valid = false;
+            break;
+        }
+        ++i;
+
+        if (std::strcmp(option, "--frames") == 0 && parseNumber(value, number) && number >= 1) {
+            config.frames = static_cast<int>(number);
+            framesGiven = true;
+        } else if (std::strcmp(option, "--fixed-dt") == 0 && parseNumber(value, number) && number >= 0) {
+            config.fixedDeltaTime = static_cast<float>(number);
+            deltaTimeGiven = true;
+        } else if (std::strcmp(option, "--capture") == 0) {
+            config.captureDirectory = value;
+        } else if (std::strcmp(option, "--capture-every") == 0 && parseNumber(value, number) && number >= 1) {
+            config.captureEvery = static_cast<int>(number);
+        } else if (std::strcmp(option, "--record") == 0) {
+            config.recordTarget = value;
+        } else if (std::strcmp(option, "--record-format") == 0 && std::strcmp(value, "png") == 0) {
+            config.recordFormat = RecordFormat::Png;
+        } else if (std::strcmp(option, "--record-format") == 0 && std::strcmp(value, "raw") == 0) {
+            config.recordFormat = RecordFormat::Raw;
+        } else if (std::strcmp(option, "--record-pipe") == 0) {
+            config.recordTarget = value;
+            config.recordFormat = RecordFormat::Pipe;
+        } else if (std::strcmp(option, "--trace") == 0) {
+            config.traceFile = value;
+        } else if (std::strcmp(option, "--alloc-gate") == 0 && parseNumber(value, number) && number >= 0) {
+            config.allocationGate = static_cast<int>(number);
+        } else if (std::strcmp(option, "--benchmark") == 0) {
+            config.benchmarkReport = value;
+        } else if (std::strcmp(option, "--resources") == 0) {
+            config.resourceDirectory = value;
+        } else {
+            std::cout << "ERROR::CONFIG: Invalid option " << option << " " << value << std::endl;
+            config.valid = false;
+            break;
+        }
+    }
+
+    if (!config.benchmarkReport.empty()) {
+        if (!framesGiven) {
+            config.frames = 3600;
+            framesGiven = true;
+        }
+        if (!deltaTimeGiven)
+            config.fixedDeltaTime = 1.0f / 60.0f;
+    }
+    if (config.headless && !framesGiven)
+        config.frames = 1;
+    if (!config.valid)
+        printUsage(argv[0]);
+    return config;
+}
+
+void EngineConfig::printUsage(const char *program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --headless          render offscreen (EGL, or no GL at all with --software) instead of\n"
+              << "                      in a window\n"
+              << "  --software          rasterize on the CPU instead of with OpenGL\n"
+              << "  --hud               start with the performance overlay shown (F1 toggles it)\n"
+              << "  --frames N          stop after N frames (default: until closed, 1 when headless)\n"
+              << "  --fixed-dt S        advance time by S seconds per frame instead of the real clock\n"
+              << "  --capture DIR       write frames to DIR/frame_NNNNN.png\n"
+              << "  --capture-every N   only capture every Nth frame (default: 1)\n"
+              << "  --record DIR        record every frame to DIR without stalling the render loop\n"
+              << "  --record-format F   png (default) or raw top-down RGBA files\n"
+              << "  --record-pipe CMD   pipe raw top-down RGBA frames to CMD, e.g.\n"
+              << "                      \"ffmpeg -f rawvideo -pix_fmt rgba -s 1000x800 -r 60 -i - out.mp4\"\n"
+              << "  --trace FILE        write a Chrome trace of the last frames to FILE on exit\n"
+              << "  --alloc-gate N      fail if a frame allocates after N warm-up frames on its screen\n"
+              << "  --benchmark FILE    play a scripted session uncapped and write frame time percentiles\n"
+              << "                      to FILE as JSON (default: 3600 frames at --fixed-dt 1/60)\n"
+              << "  --resources DIR     load shaders and fonts from DIR (e.g. ../res) when present there,\n"
+              << "                      instead of the copies built into the binary" << std::endl;
+}
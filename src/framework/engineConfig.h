@@ -0,0 +1,83 @@
+#ifndef GRAPHICS_ENGINECONFIG_H
+#define GRAPHICS_ENGINECONFIG_H
+
+#include <string>
+
+#include "frameRecorder.h"
+
+/// @brief Startup options of the engine, parsed from the command line
+struct EngineConfig {
+    /// @brief Render offscreen into a framebuffer object instead of a window (--headless)
+    /// @details Needs EGL, unless combined with --software; there is no input, so the game stays on whatever
+    /// screen it starts on.
+    bool headless = false;
+
+    /// @brief Stop after this many frames (--frames N, N >= 1); 0 runs until the window is closed
+    /// @details Defaults to 1 when headless, since nothing else can stop the loop.
+    int frames = 0;
+
+    /// @brief Rasterize on the CPU with the SoftwareRenderer instead of drawing with OpenGL (--software)
+    /// @details In a window a GL context is still used to show the result. With --headless no context is
+    /// created at all (see needsContext()).
+    bool software = false;
+
+    /// @brief Start with the performance overlay shown (--hud); F1 toggles it
+    bool showHud = false;
+
+    /// @brief Advance time by this many seconds every frame (--fixed-dt S); 0 uses the real clock
+    /// @details Makes runs reproducible, e.g. for comparing captured frames.
+    float fixedDeltaTime = 0.0f;
+
+    /// @brief Directory captured frames are written to as PNG files (--capture DIR); empty disables capture
+    std::string captureDirectory;
+
+    /// @brief Capture every Nth frame (--capture-every N)
+    int captureEvery = 1;
+
+    /// @brief Record every frame asynchronously (--record DIR, or --record-pipe CMD); empty disables recording
+    /// @details Unlike --capture this never waits for the GPU, so it suits recording gameplay in a window.
+    /// Holds the directory, or the command frames are piped to when recordFormat is RecordFormat::Pipe.
+    std::string recordTarget;
+
+    /// @brief How recorded frames are stored (--record-format png|raw; --record-pipe selects Pipe)
+    RecordFormat recordFormat = RecordFormat::Png;
+
+    /// @brief Write a Chrome trace of the last frames to this file on exit (--trace FILE); empty disables it
+    /// @details Also prints the profiler's zone percentiles. Needs a build with the PROFILER option.
+    std::string traceFile;
+
+    /// @brief Fail the run if a frame allocates after this many warm-up frames on its screen (--alloc-gate N)
+    /// @details -1 disables the gate. Frames that change screens are skipped, since those rebuild the level.
+    /// Needs a build with the TRACK_ALLOCATIONS option.
+    int allocationGate = -1;
+
+    /// @brief Play a scripted session through every difficulty and write frame time percentiles to this file
+    /// (--benchmark FILE); empty disables it
+    /// @details The script replaces keyboard input and vsync is turned off. Unless given, the time step is
+    /// fixed to 1/60 s and the run stops after 3600 frames, so runs are comparable.
+    std::string benchmarkReport;
+
+    /// @brief Seed of rand() and of the random level in a benchmark, instead of the time
+    /// @details rand() is seeded once rather than every frame, so every run plays the same game.
+    static constexpr unsigned int benchmarkSeed = 1;
+
+    /// @brief Directory whose files replace the embedded resources of the same name (--resources DIR); empty
+    /// uses only the embedded ones
+    /// @details For development, e.g. --resources ../res picks up edited shaders without rebuilding.
+    std::string resourceDirectory;
+
+    /// @brief False if the command line could not be parsed
+    bool valid = true;
+
+    /// @brief Returns false if nothing is drawn with OpenGL: --software with --headless needs no context
+    bool needsContext() const { return !software || !headless; }
+
+    /// @brief Parses the command line
+    /// @details Prints the usage and sets valid to false on unknown or malformed options.
+    static EngineConfig parse(int argc, char *argv[]);
+
+    /// @brief Prints the supported options
+    static void printUsage(const char *program);
+};
+
+#endif //GRAPHICS_ENGINECONFIG_H
@@ -0,0 +1,212 @@
+#include "frameRecorder.h"
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#include "pngWriter.h"
+#include "allocationTracker.h"
+#include "profiler.h"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+// frames are binary; without "b" Windows would translate newline bytes
+#define PIPE_MODE "wb"
+#else
+#define PIPE_MODE "w"
+#endif
+
+FrameRecorder::FrameRecorder(int width, int height, RecordFormat format, const std::string &target, bool readBack)
+    : width(width), height(height), format(format), target(target) {
+    if (readBack) {
+        const GLsizeiptr frameBytes = GLsizeiptr(width) * height * 4;
+        for (Slot &slot : slots) {
+            glGenBuffers(1, &slot.pbo);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes, nullptr, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    if (format == RecordFormat::Pipe) {
+        pipe = popen(target.c_str(), PIPE_MODE);
+        if (!pipe) {
+            std::cout << "ERROR::RECORDER: Failed to start " << target << std::endl;
+        }
+    } else {
+        std::error_code error;
+        std::filesystem::create_directories(target, error);
+    }
+
+    worker = std::thread(&FrameRecorder::workerLoop, this);
+}
+
+FrameRecorder::~FrameRecorder() {
+    finish();
+    for (Slot &slot : slots) {
+        if (slot.pbo != 0)
+            glDeleteBuffers(1, &slot.pbo);
+    }
+}
+
+void FrameRecorder::capture(int frameIndex) {
+    PROFILE_ZONE("FrameRecorder::capture");
+    ALLOCATION_SCOPE("Recorder");
+    if (finished)
+        return;
+
+    // The slot was last filled slotCount frames ago, so its copy is done and mapping it will not stall
+    Slot &slot = slots[nextSlot];
+    if (slot.fence) {
+        collect(slot);
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    // with a pack buffer bound this only queues the copy and returns
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frameIndex = frameIndex;
+
+    nextSlot = (nextSlot + 1) % slotCount;
+}
+
+void FrameRecorder::capture(int frameIndex, const unsigned char *pixels) {
+    PROFILE_ZONE("FrameRecorder::capture");
+    ALLOCATION_SCOPE("Recorder");
+    if (finished)
+        return;
+    queue(frameIndex, pixels);
+}
+
+void FrameRecorder::collect(Slot &slot) {
+    // normally signaled long ago; the timeout only matters if the GPU is far behind
+    glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    void *mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, GLsizeiptr(width) * height * 4, GL_MAP_READ_BIT);
+    if (mapped) {
+        queue(slot.frameIndex, mapped);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!mapped) {
+        std::cout << "ERROR::RECORDER: Failed to map frame " << slot.frameIndex << std::endl;
+    }
+}
+
+void FrameRecorder::queue(int frameIndex, const void *pixels) {
+    std::vector<unsigned char> buffer;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobs.size() >= maxQueuedJobs) {
+            // the worker cannot keep up; skip the frame rather than wait for it
+            dropped++;
+            return;
+        }
+        if (!freeBuffers.empty()) {
+            buffer.swap(freeBuffers.back());
+            freeBuffers.pop_back();
+        }
+    }
+
+    const size_t frameBytes = size_t(width) * height * 4;
+    buffer.resize(frameBytes);
+    std::memcpy(buffer.data(), pixels, frameBytes);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back({frameIndex, std::move(buffer)});
+    }
+    wake.notify_one();
+}
+
+void FrameRecorder::finish() {
+    if (finished)
+        return;
+    finished = true;
+
+    // Collect the frames still in flight, oldest first
+    for (int i = 0; i < slotCount; ++i) {
+        Slot &slot = slots[(nextSlot + i) % slotCount];
+        if (slot.fence) {
+            collect(slot);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+
+    if (pipe) {
+        pclose(pipe);
+        pipe = nullptr;
+    }
+    std::cout << "Recorder: wrote " << written << " frames to " << target;
+    if (dropped > 0) {
+        std::cout << " (" << dropped << " dropped)";
+    }
+    std::cout << std::endl;
+}
+
+void FrameRecorder::workerLoop() {
+    Profiler::setThreadName("frame recorder");
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) {
+            // stopping, and everything queued has been written
+            return;
+        }
+
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+        write(job);
+        lock.lock();
+
+        freeBuffers.push_back(std::move(job.pixels));
+    }
+}
+
+void FrameRecorder::write(Job &job) {
+    PROFILE_ZONE("FrameRecorder::write");
+    char name[32];
+    if (format == RecordFormat::Png) {
+        snprintf(name, sizeof(name), "/frame_%05d.png", job.frameIndex);
+        if (writePng(target + name, width, height, job.pixels.data())) {
+            written++;
+        }
+        return;
+    }
+
+    // glReadPixels returns the bottom row first; raw output is top-down like the PNGs
+    const size_t rowBytes = size_t(width) * 4;
+    flipped.resize(job.pixels.size());
+    for (int y = 0; y < height; ++y) {
+        std::memcpy(flipped.data() + y * rowBytes, job.pixels.data() + (height - 1 - y) * rowBytes, rowBytes);
+    }
+
+    if (format == RecordFormat::Pipe) {
+        if (pipe && fwrite(flipped.data(), 1, flipped.size(), pipe) == flipped.size()) {
+            written++;
+        }
+        return;
+    }
+
+    snprintf(name, sizeof(name), "/frame_%05d.rgba", job.frameIndex);
+    FILE *file = fopen((target + name).c_str(), "wb");
+    if (file) {
+        if (fwrite(flipped.data(), 1, flipped.size(), file) == flipped.size()) {
+            written++;
+        }
+        fclose(file);
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef GRAPHICS_FRAMERECORDER_H
+#define GRAPHICS_FRAMERECORDER_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+
+/// @brief How recorded frames are stored
+enum class RecordFormat {
+    /// @brief One PNG file per frame
+    Png,
+    /// @brief One file of raw, top-down RGBA bytes per frame
+    Raw,
+    /// @brief Raw, top-down RGBA frames written to the standard input of a command (e.g. an encoder)
+    Pipe
+};
+
+/// @brief Records rendered frames without stalling the render loop.
+/// @details glReadPixels goes into a ring of pixel buffer objects, so the copy happens on the GPU's
+/// schedule. A frame is mapped slotCount frames later, when its fence has long signaled, and handed to a
+/// worker thread that encodes and writes it. If the worker falls behind, frames are dropped instead of
+/// blocking the render loop. Frames drawn on the CPU (SoftwareRenderer) are copied and queued directly.
+class FrameRecorder {
+public:
+    /// @brief Creates the pixel buffer objects and starts the worker thread
+    /// @param width The width of the frames
+    /// @param height The height of the frames
+    /// @param format How frames are stored
+    /// @param target The output directory, or the command to pipe frames to for RecordFormat::Pipe
+    /// @param readBack false if every frame is passed to capture() as CPU pixels; no GL objects are created then
+    FrameRecorder(int width, int height, RecordFormat format, const std::string &target, bool readBack = true);
+
+    /// @brief Finishes recording (see finish()) and deletes the pixel buffer objects
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder &) = delete;
+    FrameRecorder &operator=(const FrameRecorder &) = delete;
+
+    /// @brief Starts reading back the frame that was just drawn
+    /// @details Call after drawing and before swapping buffers. Collects the frame read slotCount calls ago.
+    void capture(int frameIndex);
+
+    /// @brief Queues a frame that is already on the CPU
+    /// @param frameIndex The number of the frame
+    /// @param pixels RGBA bytes, bottom row first like glReadPixels
+    void capture(int frameIndex, const unsigned char *pixels);
+
+    /// @brief Collects the frames still in flight, waits for the worker to write them and stops it
+    void finish();
+
+private:
+    struct Slot {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+        int frameIndex = 0;
+    };
+
+    struct Job {
+        int frameIndex;
+        std::vector<unsigned char> pixels;
+    };
+
+    /// @brief Number of frames read back at the same time
+    static const int slotCount = 3;
+
+    /// @brief Frames waiting for the worker before new ones are dropped
+    static const size_t maxQueuedJobs = 8;
+
+    /// @brief Maps a slot's buffer and queues its pixels for the worker
+    void collect(Slot &slot);
+
+    /// @brief Copies a frame into a free buffer and hands it to the worker, or drops it if the worker is behind
+    void queue(int frameIndex, const void *pixels);
+
+    void workerLoop();
+
+    /// @brief Encodes and writes a frame; runs on the worker thread
+    void write(Job &job);
+
+    int width, height;
+    RecordFormat format;
+    std::string target;
+
+    Slot slots[slotCount];
+    int nextSlot = 0;
+    bool finished = false;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> jobs;
+    /// @brief Pixel buffers returned by the worker, reused so recording does not allocate every frame
+    std::vector<std::vector<unsigned char>> freeBuffers;
+    bool stopping = false;
+
+    FILE *pipe = nullptr;
+    /// @brief Row order is flipped on the worker, into this buffer
+    std::vector<unsigned char> flipped;
+
+    int written = 0, dropped = 0;
+};
+
+#endif //GRAPHICS_FRAMERECORDER_H
@@ -0,0 +1,78 @@
+#include "frameTimeReport.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+FrameTimeReport::FrameTimeReport(int expectedFrames, int warmupFrames) : warmupFrames(warmupFrames) {
+    for (std::vector<float> *samples : {&input, &update, &render, &frame}) {
+        samples->reserve(expectedFrames);
+    }
+}
+
+void FrameTimeReport::addFrame(float inputMilliseconds, float updateMilliseconds, float renderMilliseconds) {
+    input.push_back(inputMilliseconds);
+    update.push_back(updateMilliseconds);
+    render.push_back(renderMilliseconds);
+    frame.push_back(inputMilliseconds + updateMilliseconds + renderMilliseconds);
+}
+
+FrameTimeReport::Summary FrameTimeReport::summarize(const std::vector<float> &samples) const {
+    Summary summary;
+    if (samples.size() <= static_cast<size_t>(warmupFrames))
+        return summary;
+
+    std::vector<float> sorted(samples.begin() + warmupFrames, samples.end());
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](float p) {
+        return sorted[std::min(static_cast<size_t>(p * (sorted.size() - 1) + 0.5f), sorted.size() - 1)];
+    };
+    summary.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+    summary.p50 = percentile(0.50f);
+    summary.p95 = percentile(0.95f);
+    summary.p99 = percentile(0.99f);
+    summary.max = sorted.back();
+    return summary;
+}
+
+void FrameTimeReport::print() const {
+    const int measured = std::max(0, static_cast<int>(frame.size()) - warmupFrames);
+    std::cout << "Frame times over " << measured << " frames after " << warmupFrames << " warm-up frames (ms):\n"
+              << std::left << std::setw(10) << "part" << std::right << std::setw(10) << "mean" << std::setw(10)
+              << "p50" << std::setw(10) << "p95" << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+    const std::pair<const char *, const std::vector<float> *> parts[] = {
+        {"input", &input}, {"update", &update}, {"render", &render}, {"frame", &frame}};
+    for (const auto &[name, samples] : parts) {
+        Summary summary = summarize(*samples);
+        std::cout << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << summary.mean << std::setw(10) << summary.p50 << std::setw(10) << summary.p95
+                  << std::setw(10) << summary.p99 << std::setw(10) << summary.max << "\n";
+    }
+    std::cout << std::defaultfloat << std::flush;
+}
+
+bool FrameTimeReport::writeJson(const std::string &path, const char *renderer, unsigned int seed) const {
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file) {
+        std::cout << "ERROR::BENCHMARK: Failed to write " << path << std::endl;
+        return false;
+    }
+
+    fprintf(file, "{\n  \"renderer\": \"%s\",\n  \"seed\": %u,\n  \"frames\": %zu,\n  \"warmupFrames\": %d,\n"
+                  "  \"milliseconds\": {", renderer, seed, frame.size(), warmupFrames);
+    const std::pair<const char *, const std::vector<float> *> parts[] = {
+        {"input", &input}, {"update", &update}, {"render", &render}, {"frame", &frame}};
+    bool first = true;
+    for (const auto &[name, samples] : parts) {
+        Summary summary = summarize(*samples);
+        fprintf(file, "%s\n    \"%s\": {\"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f}",
+                first ? "" : ",", name, summary.mean, summary.p50, summary.p95, summary.p99, summary.max);
+        first = false;
+    }
+    fprintf(file, "\n  }\n}\n");
+    bool written = fclose(file) == 0;
+    std::cout << "Benchmark: wrote " << path << std::endl;
+    return written;
+}
@@ -0,0 +1,40 @@
+#ifndef GRAPHICS_FRAMETIMEREPORT_H
+#define GRAPHICS_FRAMETIMEREPORT_H
+
+#include <string>
+#include <vector>
+
+/// @brief Collects the input, update and render time of every frame of a benchmark run and summarizes them
+/// @details Reports the mean, 50th, 95th and 99th percentile and maximum of each part and of the whole
+/// frame, ignoring the first warmupFrames frames (shader compilation, first uploads, glyph loading).
+class FrameTimeReport {
+public:
+    /// @param expectedFrames Frames to reserve room for, so recording does not allocate
+    /// @param warmupFrames Frames at the start that are left out of the statistics
+    FrameTimeReport(int expectedFrames, int warmupFrames);
+
+    /// @brief Records one frame; times in milliseconds
+    void addFrame(float inputMilliseconds, float updateMilliseconds, float renderMilliseconds);
+
+    /// @brief Prints a table of the statistics
+    void print() const;
+
+    /// @brief Writes the statistics as JSON, for comparing runs
+    /// @param renderer Name of the renderer backend, stored with the results
+    /// @param seed Seed the game was played with, stored with the results
+    /// @return false if the file could not be written
+    bool writeJson(const std::string &path, const char *renderer, unsigned int seed) const;
+
+private:
+    struct Summary {
+        float mean = 0, p50 = 0, p95 = 0, p99 = 0, max = 0;
+    };
+
+    /// @brief Summarizes the frames after the warm-up of one part
+    Summary summarize(const std::vector<float> &samples) const;
+
+    int warmupFrames;
+    std::vector<float> input, update, render, frame;
+};
+
+#endif //GRAPHICS_FRAMETIMEREPORT_H
@@ -0,0 +1,276 @@
+#include "glRenderer.h"
+
+#include <algorithm>
+
+#include "profiler.h"
+
+namespace {
+    /// @brief GPU timer section names, by RenderLayer
+    const char *const layerSectionNames[] = {"GPU Background", "GPU Bricks", "GPU Actors", "GPU Text", "GPU Overlay"};
+
+    /// @brief Least distance between the particle arrays in the stream
+    /// @details Mesa merges attributes of a buffer that are less than 2 KB apart into one vertex binding, and then
+    /// compiles a new vertex fetch for every new distance, i.e. for every particle count below 512.
+    const GLsizeiptr minParticleArrayBytes = 4096;
+}
+
+GLRenderer::GLRenderer(ShaderManager &shaderManager, FontRenderer &fontRenderer)
+    : Renderer(shaderManager, fontRenderer) {
+    instanceBatch.reserve(initialCapacity);
+    spriteModelUniform = spriteShader.getUniform<mat4>("model");
+    spriteColorUniform = spriteShader.getUniform<vec3>("spriteColor");
+
+    // Instanced shapes share the unit quad; their per-instance attributes are pointed at
+    // the instance stream in drawInstances(), once the offset of the frame's data is known
+    const Mesh &quad = MeshManager::getMesh(MeshType::Quad);
+    glGenVertexArrays(1, &instanceVAO);
+    glBindVertexArray(instanceVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quad.VBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad.EBO);
+    for (GLuint attribute = 1; attribute <= 3; ++attribute) {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+    glBindVertexArray(0);
+
+    // Particles: the unit quad per vertex, and per instance one attribute per particle array
+    particleSizeUniform = particleShader.getUniform<float>("particleSize");
+    glGenVertexArrays(1, &particleVAO);
+    glBindVertexArray(particleVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quad.VBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad.EBO);
+    for (GLuint attribute = 1; attribute <= 4; ++attribute) {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+GLRenderer::~GLRenderer() {
+    glDeleteVertexArrays(1, &instanceVAO);
+    glDeleteVertexArrays(1, &particleVAO);
+}
+
+void GLRenderer::reserveParticles(size_t count) {
+    createParticleStream(count);
+
+    // Particles first show up when a brick breaks, in the middle of a level. Draw an invisible one from every
+    // segment now, so drivers that compile shader variants on first use (e.g. llvmpipe) do it while loading.
+    ParticleSystem warmUp(count);
+    warmUp.emitBurst(vec2(-100.0f), vec2(0.0f), vec4(0.0f), vec2(0.0f), 1);
+    for (int segment = 0; segment < StreamBuffer::segmentCount; ++segment) {
+        GLuint program = 0, vao = 0;
+        particleStream->beginFrame();
+        drawParticles(warmUp, program, vao);
+        particleStream->endFrame();
+    }
+    glBindVertexArray(0);
+}
+
+void GLRenderer::setGpuTiming(bool enable) {
+    gpuTimer.setEnabled(enable);
+}
+
+void GLRenderer::createParticleStream(size_t capacity) {
+    // four arrays of four byte values
+    const GLsizeiptr arrayBytes = std::max(static_cast<GLsizeiptr>(capacity * sizeof(float)), minParticleArrayBytes);
+    particleStream = std::make_unique<StreamBuffer>(4 * arrayBytes);
+    particleStreamCapacity = capacity;
+}
+
+void GLRenderer::clear(vec4 color) {
+    glClearColor(color.x, color.y, color.z, color.w);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void GLRenderer::drawInstances(GLuint &program, GLuint &vao) {
+    const GLsizeiptr stride = sizeof(ShapeInstance);
+    if (circleShader.ID != program) {
+        program = circleShader.use().ID;
+    }
+    glBindVertexArray(instanceVAO);
+    vao = instanceVAO;
+    glStats.stateChanges++;
+
+    const Mesh &quad = MeshManager::getMesh(MeshType::Quad);
+    size_t first = 0;
+    while (first < instanceBatch.size()) {
+        size_t count = std::min(instanceBatch.size() - first, size_t(instanceStream.available(sizeof(float)) / stride));
+        if (count == 0) {
+            // The segment is full: fence the draws that read it and go on in the next one
+            instanceStream.endFrame();
+            instanceStream.beginFrame();
+            continue;
+        }
+        GLintptr offset = instanceStream.upload(&instanceBatch[first], count * stride, sizeof(float));
+
+        // GL 3.3 has no base instance, so the attributes are pointed at this part of the batch instead
+        glBindBuffer(GL_ARRAY_BUFFER, instanceStream.getBuffer());
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(ShapeInstance, center)));
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(ShapeInstance, color)));
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(ShapeInstance, cornerRadius)));
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDrawElementsInstanced(quad.mode, quad.count, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(count));
+        glStats.stateChanges += 5;
+        glStats.drawCalls++;
+        first += count;
+    }
+    instanceBatch.clear();
+}
+
+void GLRenderer::drawParticles(const ParticleSystem &particles, GLuint &program, GLuint &vao) {
+    PROFILE_ZONE("GLRenderer::drawParticles");
+    if (particles.size() == 0)
+        return;
+    if (particleShader.ID != program) {
+        program = particleShader.use().ID;
+    }
+    particleShader.set(particleSizeUniform, ParticleSystem::particleSize);
+    glBindVertexArray(particleVAO);
+    vao = particleVAO;
+
+    // The live part of every array, at least minParticleArrayBytes apart; a segment has room for a full system
+    if (particles.capacity() > particleStreamCapacity)
+        createParticleStream(particles.capacity());
+    const GLsizeiptr count = static_cast<GLsizeiptr>(particles.size());
+    const GLsizeiptr liveBytes = count * sizeof(float);
+    const GLsizeiptr arrayBytes = std::max(liveBytes, minParticleArrayBytes);
+    const GLintptr offset = particleStream->allocate(4 * arrayBytes, sizeof(float));
+    if (offset < 0)
+        return;
+    particleStream->write(offset, particles.getPosX(), liveBytes);
+    particleStream->write(offset + arrayBytes, particles.getPosY(), liveBytes);
+    particleStream->write(offset + 2 * arrayBytes, particles.getLife(), liveBytes);
+    particleStream->write(offset + 3 * arrayBytes, particles.getColors(), liveBytes);
+    glBindBuffer(GL_ARRAY_BUFFER, particleStream->getBuffer());
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)offset);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(offset + arrayBytes));
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(offset + 2 * arrayBytes));
+    glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(uint32_t), (void*)(offset + 3 * arrayBytes));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    const Mesh &quad = MeshManager::getMesh(MeshType::Quad);
+    glDrawElementsInstanced(quad.mode, quad.count, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(count));
+    glStats.stateChanges += 7;
+    glStats.drawCalls++;
+}
+
+void GLRenderer::execute() {
+    PROFILE_ZONE("GLRenderer::execute");
+    // State currently bound, so redundant binds can be skipped
+    GLuint program = 0, vao = 0, texture = 0;
+    bool textActive = false;
+    int layer = -1;
+
+    gpuTimer.beginFrame();
+    instanceStream.beginFrame();
+    if (particleStream)
+        particleStream->beginFrame();
+    for (const Command &command : commands) {
+        // Every layer is timed as its own GPU section, so batches end with the layer
+        const int commandLayer = static_cast<int>(command.key >> 56);
+        const bool newLayer = commandLayer != layer;
+
+        // Instances are collected until a command of another kind comes up
+        if (!instanceBatch.empty() && (newLayer || command.pipeline != Pipeline::Instance)) {
+            drawInstances(program, vao);
+        }
+
+        bool isText = command.pipeline == Pipeline::Text || command.pipeline == Pipeline::Layout;
+        // Text runs bind their own state, so forget what we had bound when leaving them
+        if (textActive && (newLayer || !isText)) {
+            fontRenderer.end();
+            textActive = false;
+            program = vao = texture = 0;
+        }
+
+        if (newLayer) {
+            gpuTimer.mark(layerSectionNames[commandLayer]);
+            layer = commandLayer;
+        }
+
+        switch (command.pipeline) {
+            case Pipeline::Shape: {
+                const Shape &shape = *shapes[command.index];
+                if (shape.getShader().ID != program) {
+                    program = shape.getShader().use().ID;
+                }
+                const Mesh &mesh = MeshManager::getMesh(shape.getMeshType());
+                if (mesh.VAO != vao) {
+                    mesh.bind();
+                    vao = mesh.VAO;
+                }
+                shape.setUniforms();
+                mesh.drawBound();
+                break;
+            }
+            case Pipeline::Sprite: {
+                const SpriteDraw &sprite = sprites[command.index];
+                if (spriteShader.ID != program) {
+                    program = spriteShader.use().ID;
+                }
+                const Mesh &mesh = MeshManager::getMesh(MeshType::Quad);
+                if (mesh.VAO != vao) {
+                    mesh.bind();
+                    vao = mesh.VAO;
+                }
+                if (sprite.texture != texture) {
+                    glActiveTexture(GL_TEXTURE0);
+                    glBindTexture(GL_TEXTURE_2D, sprite.texture);
+                    glStats.stateChanges += 2;
+                    texture = sprite.texture;
+                }
+                spriteShader.set(spriteModelUniform, sprite.model);
+                spriteShader.set(spriteColorUniform, sprite.color);
+                mesh.drawBound();
+                break;
+            }
+            case Pipeline::Text: {
+                if (!textActive) {
+                    fontRenderer.begin();
+                    textActive = true;
+                }
+                const TextDraw &text = texts[command.index];
+                fontRenderer.draw(textBuffer.data() + text.offset, text.length, text.x, text.y, text.scale, text.color);
+                break;
+            }
+            case Pipeline::Layout: {
+                // Cached layouts share the text program and atlas, only their VAO differs
+                if (!textActive) {
+                    fontRenderer.begin();
+                    textActive = true;
+                }
+                layouts[command.index]->draw();
+                break;
+            }
+            case Pipeline::Instance: {
+                instanceBatch.push_back(instances[command.index]);
+                break;
+            }
+            case Pipeline::Particles: {
+                drawParticles(*particleSystems[command.index], program, vao);
+                break;
+            }
+        }
+    }
+
+    if (!instanceBatch.empty()) {
+        drawInstances(program, vao);
+    }
+
+    if (textActive) {
+        fontRenderer.end();
+    } else if (vao != 0) {
+        glBindVertexArray(0);
+        glStats.stateChanges++;
+    }
+    instanceStream.endFrame();
+    if (particleStream)
+        particleStream->endFrame();
+    gpuTimer.endFrame();
+}
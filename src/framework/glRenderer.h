@@ -0,0 +1,81 @@
+#ifndef GRAPHICS_GLRENDERER_H
+#define GRAPHICS_GLRENDERER_H
+
+#include "renderer.h"
+#include "streamBuffer.h"
+#include "gpuTimer.h"
+
+#include <memory>
+
+/// @brief Renderer backend that replays the sorted commands with OpenGL.
+/// @details Program, VAO and texture binds that are already current are skipped, and consecutive
+/// instanced shapes are drawn with one call. In profiler builds every layer can be timed on the GPU.
+class GLRenderer : public Renderer {
+public:
+    /// @brief Construct a new GLRenderer
+    /// @param shaderManager Used to look up the "sprite" and "circle" programs
+    /// @param fontRenderer Used to replay text runs
+    GLRenderer(ShaderManager &shaderManager, FontRenderer &fontRenderer);
+
+    /// @brief Destroys the VAOs
+    ~GLRenderer() override;
+
+    void clear(vec4 color) override;
+
+    /// @brief Creates the particle stream buffer for systems of up to count particles and warms up the driver
+    void reserveParticles(size_t count) override;
+
+    void setGpuTiming(bool enable) override;
+
+protected:
+    void execute() override;
+
+private:
+    /// @brief Uploads the collected instances and draws them, with one call per instanceStream segment they fill
+    /// @param program Updated with the program left bound
+    /// @param vao Updated with the VAO left bound
+    void drawInstances(GLuint &program, GLuint &vao);
+
+    /// @brief Uploads the live part of the arrays of a particle system and draws the particles with one call
+    /// @details Does nothing if no particle is alive.
+    /// @param program Updated with the program left bound
+    /// @param vao Updated with the VAO left bound
+    void drawParticles(const ParticleSystem &particles, GLuint &program, GLuint &vao);
+
+    /// @brief (Re)creates particleStream with room for one system of the given capacity per frame
+    void createParticleStream(size_t capacity);
+
+    /// @brief Bytes of instance data per instanceStream segment, about 7k instances
+    static const GLsizeiptr instanceSegmentSize = 1 << 18;
+
+    /// @brief VAO used for instanced shapes
+    /// @details Reads the unit quad per vertex and ShapeInstance data per instance from instanceStream.
+    GLuint instanceVAO = 0;
+
+    /// @brief VAO used for particles
+    GLuint particleVAO = 0;
+
+    /// @brief Stream buffer the instances are uploaded through, separate from the shared one
+    /// @details A frame with more instances than fit in a segment fences the draws that read it and continues in
+    /// the next one, which would discard the frame uniforms and text in the shared buffer when orphaning.
+    StreamBuffer instanceStream{instanceSegmentSize};
+
+    /// @brief Stream buffer the particle arrays are uploaded through, separate from the shared one
+    /// @details The arrays are too large to share a segment with the rest of the frame. Each segment has room for
+    /// the arrays of one full system; only the live particles are uploaded.
+    std::unique_ptr<StreamBuffer> particleStream;
+    size_t particleStreamCapacity = 0;
+
+    /// @brief Uniform handles used for sprites
+    Uniform<mat4> spriteModelUniform;
+    Uniform<vec3> spriteColorUniform;
+    Uniform<float> particleSizeUniform;
+
+    /// @brief Times each layer on the GPU
+    GpuTimer gpuTimer;
+
+    /// @brief Instances of consecutive commands, drawn together
+    vector<ShapeInstance> instanceBatch;
+};
+
+#endif //GRAPHICS_GLRENDERER_H
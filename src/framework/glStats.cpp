@@ -0,0 +1,3 @@
+#include "glStats.h"
+
+GLStats glStats;
@@ -0,0 +1,31 @@
+#ifndef GRAPHICS_GLSTATS_H
+#define GRAPHICS_GLSTATS_H
+
+/// @brief Counters for the OpenGL calls made by the engine during one frame.
+/// @details Incremented by the wrappers that issue the calls (Shader, Mesh, FontRenderer)
+/// and reset by the Engine at the start of every frame.
+struct GLStats {
+    /// @brief glGetUniformLocation calls
+    unsigned int uniformLookups = 0;
+    /// @brief glUniform* calls
+    unsigned int uniformUploads = 0;
+    /// @brief glDraw* calls
+    unsigned int drawCalls = 0;
+    /// @brief Program, VAO, buffer and texture binds
+    unsigned int stateChanges = 0;
+    /// @brief Buffer uploads (glBufferData / glBufferSubData)
+    unsigned int bufferUploads = 0;
+
+    /// @brief Returns the sum of all counters
+    unsigned int total() const {
+        return uniformLookups + uniformUploads + drawCalls + stateChanges + bufferUploads;
+    }
+
+    /// @brief Sets all counters back to zero
+    void reset() { *this = GLStats(); }
+};
+
+/// @brief The counters for the frame currently being rendered
+extern GLStats glStats;
+
+#endif //GRAPHICS_GLSTATS_H
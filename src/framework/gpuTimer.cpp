@@ -0,0 +1,98 @@
+#include "gpuTimer.h"
+
+#include "profiler.h"
+
+GpuTimer::GpuTimer() {
+#ifdef ENABLE_PROFILER
+    // Timer queries are core since GL 3.3
+    supported = GLAD_GL_VERSION_3_3 || GLAD_GL_ARB_timer_query;
+#endif
+    if (!supported)
+        return;
+
+    for (Frame &frame : frames) {
+        glGenQueries(maxSections + 1, frame.queries);
+    }
+}
+
+GpuTimer::~GpuTimer() {
+    if (!supported)
+        return;
+    for (Frame &frame : frames) {
+        glDeleteQueries(maxSections + 1, frame.queries);
+    }
+}
+
+void GpuTimer::setEnabled(bool enable) {
+    if (!supported || enable == enabled)
+        return;
+    enabled = enable;
+    // queries left from an earlier run are not read, their sections would be long out of date
+    for (Frame &frame : frames) {
+        frame.count = 0;
+        frame.pending = false;
+    }
+    if (enabled)
+        calibrate();
+}
+
+void GpuTimer::beginFrame() {
+    if (!enabled)
+        return;
+
+    current = (current + 1) % frameLatency;
+    Frame &frame = frames[current];
+    if (frame.pending) {
+        // timestamps complete in order, so the last one being available means they all are
+        GLint available = 0;
+        glGetQueryObjectiv(frame.queries[frame.count], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            collect(frame);
+        }
+    }
+    frame.count = 0;
+    frame.pending = false;
+}
+
+void GpuTimer::mark(const char *name) {
+    Frame &frame = frames[current];
+    if (!enabled || frame.count == maxSections)
+        return;
+    // Deferred renderers such as llvmpipe only execute draws when the command stream is flushed, which
+    // would put every timestamp of the frame at the same point; flushing here makes each section run in turn
+    glFlush();
+    glQueryCounter(frame.queries[frame.count], GL_TIMESTAMP);
+    frame.names[frame.count++] = name;
+}
+
+void GpuTimer::endFrame() {
+    Frame &frame = frames[current];
+    if (!enabled || frame.count == 0)
+        return;
+    glFlush();
+    glQueryCounter(frame.queries[frame.count], GL_TIMESTAMP);
+    frame.pending = true;
+}
+
+void GpuTimer::collect(Frame &frame) {
+    // the clocks drift apart slowly, so measuring the offset about once a second is enough
+    if (++framesSinceCalibration >= 60) {
+        calibrate();
+    }
+
+    GLuint64 timestamps[maxSections + 1];
+    for (int i = 0; i <= frame.count; ++i) {
+        glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &timestamps[i]);
+    }
+    for (int i = 0; i < frame.count; ++i) {
+        Profiler::recordGpu(frame.names[i], timestamps[i] + clockOffset, timestamps[i + 1] + clockOffset);
+    }
+}
+
+void GpuTimer::calibrate() {
+    // GL_TIMESTAMP is the GPU time once all previous commands have reached the GPU, without waiting for them
+    GLint64 gpuTime = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+    clockOffset = static_cast<int64_t>(Profiler::now()) - gpuTime;
+    framesSinceCalibration = 0;
+}
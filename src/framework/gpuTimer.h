@@ -0,0 +1,72 @@
+#ifndef GRAPHICS_GPUTIMER_H
+#define GRAPHICS_GPUTIMER_H
+
+#include <cstdint>
+
+#include <glad/glad.h>
+
+/// @brief Measures how long the GPU spends on each section of a frame.
+/// @details mark() flushes and drops a GL_TIMESTAMP query into the command stream; a section lasts from its
+/// mark to the next one, or to endFrame(). Results are read frameLatency frames later, when they are long available, so
+/// reading never stalls; frames whose queries are still pending by then are skipped. The sections are passed
+/// to the Profiler on its "GPU" track, shifted onto the CPU clock, so they line up with the CPU zones.
+/// Only available in profiler builds (ENABLE_PROFILER), and off until setEnabled(), since the flushes cost
+/// throughput.
+class GpuTimer {
+public:
+    /// @brief Creates the queries (requires a current OpenGL context)
+    GpuTimer();
+
+    /// @brief Deletes the queries
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer &) = delete;
+    GpuTimer &operator=(const GpuTimer &) = delete;
+
+    /// @brief Starts or stops timing; ignored if timer queries are not available
+    void setEnabled(bool enable);
+
+    /// @brief Collects the results of frameLatency frames ago and starts a new frame
+    void beginFrame();
+
+    /// @brief Starts a new section
+    /// @param name A string literal, shown as the zone name
+    void mark(const char *name);
+
+    /// @brief Ends the last section
+    void endFrame();
+
+private:
+    /// @brief Frames between recording queries and reading them
+    static const int frameLatency = 4;
+
+    /// @brief Sections per frame; later marks are ignored
+    static const int maxSections = 8;
+
+    struct Frame {
+        /// @brief One timestamp per section start, plus the end of the last section
+        GLuint queries[maxSections + 1] = {};
+        const char *names[maxSections] = {};
+        int count = 0;
+        bool pending = false;
+    };
+
+    /// @brief Passes the sections of a finished frame to the profiler
+    void collect(Frame &frame);
+
+    /// @brief Measures the offset from the GPU clock to the profiler's clock
+    void calibrate();
+
+    Frame frames[frameLatency];
+    int current = 0;
+
+    /// @brief The queries were created, and whether they are currently used
+    bool supported = false;
+    bool enabled = false;
+
+    /// @brief Profiler time minus GPU time, in nanoseconds
+    int64_t clockOffset = 0;
+    int framesSinceCalibration = 0;
+};
+
+#endif //GRAPHICS_GPUTIMER_H
@@ -0,0 +1,36 @@
+#ifndef GRAPHICS_HEADLESSCONTEXT_H
+#define GRAPHICS_HEADLESSCONTEXT_H
+
+#include <vector>
+
+#include <glad/glad.h>
+
+/// @brief An OpenGL 3.3 core context without a window, rendering into a framebuffer object.
+/// @details Uses EGL, preferring Mesa's surfaceless platform, so it runs on machines without a display
+/// server or GPU (e.g. with llvmpipe). Only available when the build found EGL (HAS_EGL).
+class HeadlessContext {
+public:
+    HeadlessContext() = default;
+    /// @brief Deletes the framebuffer and destroys the context
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext &) = delete;
+    HeadlessContext &operator=(const HeadlessContext &) = delete;
+
+    /// @brief Creates the context, makes it current, loads GL and binds a width x height framebuffer
+    /// @return false if no context could be created
+    bool init(int width, int height);
+
+    /// @brief Returns the framebuffer everything is rendered into
+    GLuint getFramebuffer() const;
+
+private:
+    /// @brief The EGLDisplay and EGLContext, kept opaque so EGL headers stay out of this header
+    void *display = nullptr;
+    void *context = nullptr;
+
+    GLuint framebuffer = 0;
+    GLuint colorBuffer = 0;
+};
+
+#endif //GRAPHICS_HEADLESSCONTEXT_H
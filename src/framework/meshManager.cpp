@@ -0,0 +1,134 @@
+#include "meshManager.h"
+
+#include <cmath>
+#include "glStats.h"
+
+Mesh MeshManager::meshes[static_cast<int>(MeshType::Count)];
+
+void Mesh::draw() const {
+    bind();
+    drawBound();
+    glBindVertexArray(0);
+    glStats.stateChanges++;
+}
+
+void Mesh::bind() const {
+    glBindVertexArray(VAO);
+    glStats.stateChanges++;
+}
+
+void Mesh::drawBound() const {
+    if (EBO != 0)
+        glDrawElements(mode, count, GL_UNSIGNED_INT, 0);
+    else
+        glDrawArrays(mode, 0, count);
+    glStats.drawCalls++;
+}
+
+const Mesh &MeshManager::getMesh(MeshType type) {
+    Mesh &mesh = meshes[static_cast<int>(type)];
+    if (mesh.VAO == 0)
+        mesh = build(type);
+    return mesh;
+}
+
+void MeshManager::clear() {
+    for (Mesh &mesh : meshes) {
+        if (mesh.VAO == 0)
+            continue;
+        glDeleteVertexArrays(1, &mesh.VAO);
+        glDeleteBuffers(1, &mesh.VBO);
+        if (mesh.EBO != 0)
+            glDeleteBuffers(1, &mesh.EBO);
+        mesh = Mesh();
+    }
+}
+
+unsigned int MeshManager::getObjectCount() {
+    unsigned int count = 0;
+    for (const Mesh &mesh : meshes) {
+        if (mesh.VAO == 0)
+            continue;
+        // VAO + VBO, plus the EBO if the mesh is indexed
+        count += mesh.EBO != 0 ? 3 : 2;
+    }
+    return count;
+}
+
+Mesh MeshManager::build(MeshType type) {
+    // These vectors are freed as soon as the data is on the GPU
+    vector<float> vertices;
+    vector<unsigned int> indices;
+
+    switch (type) {
+        case MeshType::Quad: {
+            vertices = {
+                -0.5f, 0.5f,   // Top left
+                0.5f, 0.5f,    // Top right
+                -0.5f, -0.5f,  // Bottom left
+                0.5f, -0.5f    // Bottom right
+            };
+            indices = {
+                0, 1, 2, // First triangle
+                1, 2, 3  // Second triangle
+            };
+            return upload(vertices, indices, GL_TRIANGLES);
+        }
+        case MeshType::Circle: {
+            // Unit circle; shapes scale it by their size in the model matrix
+            vertices.reserve((circleSegments + 2) * 2);
+            // Center of circle
+            vertices.push_back(0.0f);
+            vertices.push_back(0.0f);
+            for (int i = 0; i <= circleSegments; ++i) {
+                float theta = 2.0f * 3.1415926f * float(i) / float(circleSegments);
+                vertices.push_back(cosf(theta)); // x = cos(theta)
+                vertices.push_back(sinf(theta)); // y = sin(theta)
+            }
+            return upload(vertices, indices, GL_TRIANGLE_FAN);
+        }
+        case MeshType::Triangle: {
+            vertices = {
+                -0.5f, -0.5f,  // Bottom left
+                0.5f, -0.5f,   // Bottom right
+                0.0f, 0.5f     // Top
+            };
+            indices = { 0, 1, 2 };
+            return upload(vertices, indices, GL_TRIANGLES);
+        }
+        default:
+            return Mesh();
+    }
+}
+
+Mesh MeshManager::upload(const vector<float> &vertices, const vector<unsigned int> &indices, GLenum mode) {
+    Mesh mesh;
+    mesh.mode = mode;
+
+    // Generate and bind VAO
+    glGenVertexArrays(1, &mesh.VAO);
+    glBindVertexArray(mesh.VAO);
+
+    // Generate VBO, bind it to VAO, and copy vertices data into it
+    glGenBuffers(1, &mesh.VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+
+    // Set the vertex attribute pointers (2 floats per vertex (x, y))
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0); // Enable the vertex attribute at location 0
+
+    if (!indices.empty()) {
+        // The EBO binding is stored in the VAO, so it stays bound
+        glGenBuffers(1, &mesh.EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+        mesh.count = static_cast<GLsizei>(indices.size());
+    } else {
+        mesh.count = static_cast<GLsizei>(vertices.size() / 2);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0); // Unbind VBO
+    return mesh;
+}
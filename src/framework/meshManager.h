@@ -0,0 +1,70 @@
+#ifndef GRAPHICS_MESHMANAGER_H
+#define GRAPHICS_MESHMANAGER_H
+
+#include <vector>
+#include <glad/glad.h>
+
+using std::vector;
+
+/// @brief The primitive meshes every shape is built from.
+enum class MeshType { Quad, Circle, Triangle, Count };
+
+/// @brief GPU handles for a primitive mesh.
+/// @details Meshes are uploaded once by the MeshManager and shared by reference between all shapes of the same type.
+struct Mesh {
+    /// @brief The Vertex Array Object, Vertex Buffer Object, and Element Buffer Object of the mesh.
+    /// @details EBO is 0 for meshes drawn without indices.
+    unsigned int VAO = 0, VBO = 0, EBO = 0;
+
+    /// @brief The primitive type passed to the draw call (e.g. GL_TRIANGLES, GL_TRIANGLE_FAN)
+    GLenum mode = GL_TRIANGLES;
+
+    /// @brief Number of indices (or vertices if EBO is 0) to draw
+    GLsizei count = 0;
+
+    /// @brief Binds the VAO and issues the draw call
+    void draw() const;
+
+    /// @brief Binds the VAO of the mesh
+    void bind() const;
+
+    /// @brief Issues the draw call, assuming the VAO is already bound
+    /// @details Used by the Renderer to draw many shapes with one VAO bind.
+    void drawBound() const;
+};
+
+/// @brief Uploads each primitive mesh once and hands out shared references to it.
+/// @details Meshes are created lazily on first use, so an OpenGL context must be current by then.
+/// The CPU-side vertex data only lives for the duration of the upload.
+class MeshManager {
+public:
+    /// @brief Number of x,y points on the border of the circle mesh
+    static const int circleSegments = 100;
+
+    /// @brief Returns the shared mesh for the given primitive, uploading it on first use
+    /// @param type The primitive to get
+    /// @return The mesh for the primitive
+    static const Mesh &getMesh(MeshType type);
+
+    /// @brief Deletes the VAO, VBO and EBO of every uploaded mesh
+    /// @note Must be called while the OpenGL context is still alive.
+    static void clear();
+
+    /// @brief Returns the number of OpenGL objects (VAOs and buffers) currently owned by the registry
+    static unsigned int getObjectCount();
+
+private:
+    /// @brief One mesh slot per MeshType, VAO == 0 until uploaded
+    static Mesh meshes[static_cast<int>(MeshType::Count)];
+
+    /// @brief Builds the vertices (and indices) of a primitive and uploads them
+    static Mesh build(MeshType type);
+
+    /// @brief Creates the VAO, VBO and (if indices is non-empty) EBO for the given data
+    /// @param vertices x,y pairs
+    /// @param indices element indices, may be empty
+    /// @param mode the primitive type used when drawing
+    static Mesh upload(const vector<float> &vertices, const vector<unsigned int> &indices, GLenum mode);
+};
+
+#endif //GRAPHICS_MESHMANAGER_H
@@ -0,0 +1,122 @@
+#include "particleSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "profiler.h"
+#include "../util/simd.h"
+
+namespace {
+    uint32_t packColor(vec4 color) {
+        auto channel = [](float value) {
+            return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        };
+        return channel(color.x) | channel(color.y) << 8 | channel(color.z) << 16 | channel(color.w) << 24;
+    }
+}
+
+ParticleSystem::ParticleSystem(size_t capacity) : maxCount(capacity) {
+    // Padded so update() can always process whole groups of four
+    const size_t padded = (capacity + 3) & ~size_t(3);
+    for (vector<float> *field : {&posX, &posY, &velX, &velY, &life, &fade}) {
+        field->resize(padded, 0.0f);
+    }
+    colors.resize(padded, 0);
+}
+
+float ParticleSystem::random() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return (randomState >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::emitBurst(vec2 center, vec2 size, vec4 color, vec2 velocity, int count) {
+    const size_t spawned = std::min(static_cast<size_t>(std::max(count, 0)), maxCount - this->count);
+    for (size_t i = this->count; i < this->count + spawned; ++i) {
+        const float angle = random() * 6.2831853f;
+        const float speed = 60.0f + random() * 240.0f;
+        posX[i] = center.x + (random() - 0.5f) * size.x;
+        posY[i] = center.y + (random() - 0.5f) * size.y;
+        velX[i] = std::cos(angle) * speed + velocity.x * 0.2f;
+        velY[i] = std::sin(angle) * speed + velocity.y * 0.2f;
+        life[i] = 1.0f;
+        // between half a second and 1.2 seconds
+        fade[i] = 1.0f / (0.5f + random() * 0.7f);
+
+        const float brightness = 0.75f + random() * 0.5f;
+        colors[i] = packColor(vec4(color.x * brightness, color.y * brightness, color.z * brightness, color.w));
+    }
+    this->count += spawned;
+}
+
+void ParticleSystem::update(float deltaTime) {
+    PROFILE_ZONE("ParticleSystem::update");
+    const Float4 dt(deltaTime), fall(gravity * deltaTime), zero(0.0f);
+    const size_t groups = count & ~size_t(3);
+    bool died = false;
+
+    for (size_t i = 0; i < groups; i += 4) {
+        const Float4 vx = Float4::load(&velX[i]);
+        const Float4 vy = Float4::load(&velY[i]) - fall;
+        const Float4 remaining = Float4::load(&life[i]) - Float4::load(&fade[i]) * dt;
+        (Float4::load(&posX[i]) + vx * dt).store(&posX[i]);
+        (Float4::load(&posY[i]) + vy * dt).store(&posY[i]);
+        vy.store(&velY[i]);
+        remaining.store(&life[i]);
+        died |= any(remaining < zero);
+    }
+    for (size_t i = groups; i < count; ++i) {
+        velY[i] -= gravity * deltaTime;
+        posX[i] += velX[i] * deltaTime;
+        posY[i] += velY[i] * deltaTime;
+        life[i] -= fade[i] * deltaTime;
+        died |= life[i] < 0.0f;
+    }
+    if (!died)
+        return;
+
+    // Fill the holes with the last live particles
+    for (size_t i = 0; i < count;) {
+        if (life[i] >= 0.0f) {
+            ++i;
+            continue;
+        }
+        const size_t last = --count;
+        posX[i] = posX[last];
+        posY[i] = posY[last];
+        velX[i] = velX[last];
+        velY[i] = velY[last];
+        life[i] = life[last];
+        fade[i] = fade[last];
+        colors[i] = colors[last];
+    }
+}
+
+void ParticleSystem::clear() {
+    count = 0;
+}
+
+size_t ParticleSystem::size() const {
+    return count;
+}
+
+size_t ParticleSystem::capacity() const {
+    return maxCount;
+}
+
+const float *ParticleSystem::getPosX() const {
+    return posX.data();
+}
+
+const float *ParticleSystem::getPosY() const {
+    return posY.data();
+}
+
+const float *ParticleSystem::getLife() const {
+    return life.data();
+}
+
+const uint32_t *ParticleSystem::getColors() const {
+    return colors.data();
+}
@@ -0,0 +1,68 @@
+#ifndef GRAPHICS_PARTICLESYSTEM_H
+#define GRAPHICS_PARTICLESYSTEM_H
+
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+using std::vector, glm::vec2, glm::vec4;
+
+/// @brief Short lived debris, e.g. the pieces of a broken brick
+/// @details Particles are stored as a structure of arrays (one array per field, padded to a multiple of
+/// four) so update() moves four particles per instruction with Float4, and the renderer can upload every
+/// array with a single copy and draw all particles with one instanced call. Dead particles are replaced by
+/// the last live one, so the live particles are always the first size() entries.
+/// Nothing is allocated after construction.
+class ParticleSystem {
+public:
+    /// @brief Diameter of a particle in pixels when it is spawned; it shrinks to nothing over its life
+    static constexpr float particleSize = 5.0f;
+
+    /// @brief Downwards acceleration in pixels per second squared
+    static constexpr float gravity = 600.0f;
+
+    /// @param capacity Most particles alive at once; further ones are not spawned
+    explicit ParticleSystem(size_t capacity);
+
+    /// @brief Spawns particles spread over a rectangle, flying outwards
+    /// @param center The center of the rectangle
+    /// @param size The width and height of the rectangle
+    /// @param color Color of the particles, varied slightly per particle
+    /// @param velocity Added (scaled down) to every particle, e.g. the velocity of what broke the rectangle
+    /// @param count Number of particles to spawn
+    void emitBurst(vec2 center, vec2 size, vec4 color, vec2 velocity, int count);
+
+    /// @brief Moves every particle, ages it and removes the ones that died
+    void update(float deltaTime);
+
+    /// @brief Removes every particle
+    void clear();
+
+    /// @brief Returns the number of live particles
+    size_t size() const;
+
+    /// @brief Returns the number of particles there is room for
+    size_t capacity() const;
+
+    /// @brief Per-particle arrays, size() entries each
+    /// @details Life goes from 1 when spawned to 0; colors are RGBA8 with red in the lowest byte.
+    const float *getPosX() const;
+    const float *getPosY() const;
+    const float *getLife() const;
+    const uint32_t *getColors() const;
+
+private:
+    /// @brief Returns a random number in [0, 1)
+    /// @details A private xorshift generator, so effects never change the sequence rand() gives the game.
+    float random();
+
+    size_t count = 0, maxCount;
+    vector<float> posX, posY, velX, velY, life;
+    /// @brief Life lost per second, the inverse of the particle's lifetime
+    vector<float> fade;
+    vector<uint32_t> colors;
+    uint32_t randomState = 0x9E3779B9u;
+};
+
+#endif //GRAPHICS_PARTICLESYSTEM_H
@@ -0,0 +1,122 @@
+#include "perfHud.h"
+#include "allocationTracker.h"
+#include "../util/fixedString.h"
+
+#include <algorithm>
+
+namespace {
+    /// @brief Longest text line; the lines are created this long so refreshing them never reallocates
+    const size_t maxLineLength = 48;
+
+    const float textScale = 0.5f, lineHeight = 16.0f, padding = 8.0f;
+    const float barWidth = 3.0f, graphHeight = 50.0f;
+    const int lineCount = 5;
+
+    /// @brief Returns the pth percentile (0-1) of a sorted array
+    float percentile(const float *sorted, int count, float p) {
+        return sorted[std::min(static_cast<int>(p * (count - 1) + 0.5f), count - 1)];
+    }
+}
+
+PerfHud::PerfHud(FontRenderer &fontRenderer, float left, float top) : left(left), top(top), text(fontRenderer) {
+    const std::string blank(maxLineLength, ' ');
+    const glm::vec3 white = {1, 1, 1};
+    float x = left + padding, y = top - padding - lineHeight * textScale * 1.5f;
+    fpsLine = text.addLine(blank, x, y, textScale, white);
+    percentileLine = text.addLine(blank, x, y - lineHeight, textScale, white);
+    glLine = text.addLine(blank, x, y - 2 * lineHeight, textScale, white);
+    simLine = text.addLine(blank, x, y - 3 * lineHeight, textScale, white);
+    allocationLine = text.addLine(blank, x, y - 4 * lineHeight, textScale, white);
+    text.reserve(lineCount * maxLineLength);
+}
+
+void PerfHud::toggle() {
+    visible = !visible;
+    // show current numbers right away instead of whatever was formatted when it was last visible
+    sinceRefresh = refreshMilliseconds;
+}
+
+bool PerfHud::isVisible() const {
+    return visible;
+}
+
+void PerfHud::recordFrame(const FrameCounters &counters) {
+    frameTimes[next] = counters.frameMilliseconds;
+    next = (next + 1) % historyFrames;
+    count = std::min(count + 1, historyFrames);
+    last = counters;
+    sinceRefresh += counters.frameMilliseconds;
+}
+
+void PerfHud::submit(Renderer &renderer) {
+    if (!visible)
+        return;
+    ALLOCATION_SCOPE("HUD");
+    if (sinceRefresh >= refreshMilliseconds) {
+        refresh();
+        sinceRefresh = 0.0f;
+    }
+
+    // The panel and the graph go one layer below the text so the text is drawn over them
+    const float panelWidth = historyFrames * barWidth + 2 * padding;
+    const float panelHeight = 2 * padding + lineCount * lineHeight + padding + graphHeight;
+    renderer.submitRoundedRect(vec2(left + panelWidth / 2, top - panelHeight / 2), vec2(panelWidth, panelHeight),
+                               4.0f, vec4(0.0f, 0.0f, 0.0f, 0.8f), RenderLayer::Text);
+
+    // Bars from the oldest frame on the left to the newest on the right
+    const float graphBottom = top - panelHeight + padding;
+    const float budgetY = graphBottom + graphHeight * budgetMilliseconds / graphMilliseconds;
+    for (int i = 0; i < count; ++i) {
+        float milliseconds = frameTimes[(next - count + i + historyFrames) % historyFrames];
+        float barHeight = std::max(1.0f, graphHeight * std::min(milliseconds / graphMilliseconds, 1.0f));
+        vec4 color = milliseconds <= budgetMilliseconds     ? vec4(0.3f, 0.9f, 0.3f, 0.9f)
+                   : milliseconds <= 2 * budgetMilliseconds ? vec4(0.9f, 0.8f, 0.2f, 0.9f)
+                                                            : vec4(0.9f, 0.3f, 0.2f, 0.9f);
+        float x = left + padding + (historyFrames - count + i + 0.5f) * barWidth;
+        renderer.submitRoundedRect(vec2(x, graphBottom + barHeight / 2), vec2(barWidth, barHeight), 0.0f, color,
+                                   RenderLayer::Text);
+    }
+    renderer.submitRoundedRect(vec2(left + panelWidth / 2, budgetY), vec2(panelWidth - 2 * padding, 1.0f), 0.0f,
+                               vec4(1.0f, 1.0f, 1.0f, 0.4f), RenderLayer::Text);
+
+    renderer.submit(text, RenderLayer::Overlay);
+}
+
+void PerfHud::refresh() {
+    if (count == 0)
+        return;
+
+    float total = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        total += frameTimes[i];
+    }
+    std::copy(frameTimes, frameTimes + count, sorted);
+    std::sort(sorted, sorted + count);
+
+    float average = total / count;
+    FixedString<maxLineLength> line;
+    line.append("FPS ").append(average > 0.0f ? 1000.0f / average : 0.0f, 1)
+        .append("  (").append(average, 2).append(" ms)");
+    text.setText(fpsLine, line);
+
+    line.clear();
+    line.append("p50 ").append(percentile(sorted, count, 0.50f), 2)
+        .append(" ms  p99 ").append(percentile(sorted, count, 0.99f), 2).append(" ms");
+    text.setText(percentileLine, line);
+
+    line.clear();
+    line.append("draws ").append(last.gl.drawCalls).append("  state changes ").append(last.gl.stateChanges);
+    text.setText(glLine, line);
+
+    line.clear();
+    line.append("sim ticks ").append(last.simTicks);
+    text.setText(simLine, line);
+
+    line.clear();
+    if (last.allocations < 0) {
+        line.append("allocs not tracked");
+    } else {
+        line.append("allocs ").append(last.allocations).append("  (").append(last.allocatedBytes).append(" bytes)");
+    }
+    text.setText(allocationLine, line);
+}
@@ -0,0 +1,75 @@
+#ifndef GRAPHICS_PERFHUD_H
+#define GRAPHICS_PERFHUD_H
+
+#include "glStats.h"
+#include "renderer.h"
+#include "../font/textLayout.h"
+
+/// @brief What the engine measured during one frame, as shown by the PerfHud
+struct FrameCounters {
+    /// @brief Wall clock time since the previous frame
+    float frameMilliseconds = 0.0f;
+    /// @brief GL calls of the frame
+    GLStats gl;
+    /// @brief Game updates run for the frame
+    int simTicks = 0;
+    /// @brief Heap allocations and bytes allocated during the frame; -1 when allocations are not tracked
+    long allocations = -1, allocatedBytes = -1;
+};
+
+/// @brief On-screen performance overlay: FPS, a frame time graph, frame time percentiles and per-frame counters.
+/// @details Cheap enough to leave on: the text is one cached TextLayout that is only formatted (into
+/// FixedString buffers) and laid out again a few times per second, and the graph is a row of rounded rects
+/// the renderer draws with a single instanced call. Nothing is allocated once the first refresh has sized
+/// the buffers.
+class PerfHud {
+public:
+    /// @brief Construct a new, hidden PerfHud
+    /// @param fontRenderer The renderer whose font the text uses
+    /// @param left The x position of the left edge of the panel
+    /// @param top The y position of the top edge of the panel
+    PerfHud(FontRenderer &fontRenderer, float left, float top);
+
+    /// @brief Shows or hides the overlay
+    void toggle();
+
+    bool isVisible() const;
+
+    /// @brief Adds a frame to the history; call every frame, also while hidden
+    void recordFrame(const FrameCounters &counters);
+
+    /// @brief Queues the overlay to be drawn above everything else, if visible
+    void submit(Renderer &renderer);
+
+private:
+    /// @brief Frames shown in the graph and used for the percentiles
+    static const int historyFrames = 120;
+
+    /// @brief How often the text is formatted and laid out again
+    static constexpr float refreshMilliseconds = 250.0f;
+
+    /// @brief Frame time at the top of the graph, and the 60 Hz budget marked on it
+    static constexpr float graphMilliseconds = 33.3f, budgetMilliseconds = 16.7f;
+
+    /// @brief Formats the counters into the text lines
+    void refresh();
+
+    float left, top;
+    bool visible = false;
+
+    /// @brief Frame times in milliseconds, oldest at next once the ring is full
+    float frameTimes[historyFrames] = {};
+    int next = 0, count = 0;
+    /// @brief Scratch for the percentiles
+    float sorted[historyFrames] = {};
+
+    /// @brief Counters of the last recorded frame
+    FrameCounters last;
+    float sinceRefresh = refreshMilliseconds;
+
+    TextLayout text;
+    /// @brief Indices of the text lines
+    size_t fpsLine, percentileLine, glLine, simLine, allocationLine;
+};
+
+#endif //GRAPHICS_PERFHUD_H
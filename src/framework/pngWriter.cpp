@@ -0,0 +1,106 @@
+#include "pngWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+    uint32_t crc32(const unsigned char *data, size_t size, uint32_t crc = 0) {
+        // built once, thread safe: the recorder's worker and captures on the main thread both write PNGs
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> entries{};
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                entries[n] = c;
+            }
+            return entries;
+        }();
+        crc = ~crc;
+        for (size_t i = 0; i < size; i++)
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    void putBigEndian(std::vector<unsigned char> &out, uint32_t value) {
+        out.push_back(static_cast<unsigned char>(value >> 24));
+        out.push_back(static_cast<unsigned char>(value >> 16));
+        out.push_back(static_cast<unsigned char>(value >> 8));
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    /// @brief Appends a chunk: length, type, data and the CRC of type and data
+    void putChunk(std::vector<unsigned char> &out, const char type[4], const std::vector<unsigned char> &data) {
+        putBigEndian(out, static_cast<uint32_t>(data.size()));
+        size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data.begin(), data.end());
+        putBigEndian(out, crc32(out.data() + start, out.size() - start));
+    }
+}
+
+bool writePng(const std::string &path, int width, int height, const unsigned char *rgba) {
+    // Scanlines top to bottom, each prefixed with filter type 0 (none)
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    std::vector<unsigned char> raw;
+    raw.reserve((rowBytes + 1) * height);
+    for (int y = height - 1; y >= 0; --y) {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgba + y * rowBytes, rgba + (y + 1) * rowBytes);
+    }
+
+#ifdef HAS_ZLIB
+    // The fastest level: frames are mostly flat colors, which even it shrinks to a few percent, and recording
+    // has to keep up with the frame rate
+    uLongf compressedSize = compressBound(static_cast<uLong>(raw.size()));
+    std::vector<unsigned char> zlib(compressedSize);
+    if (compress2(zlib.data(), &compressedSize, raw.data(), static_cast<uLong>(raw.size()), Z_BEST_SPEED) != Z_OK)
+        return false;
+    zlib.resize(compressedSize);
+#else
+    // zlib stream of stored deflate blocks (at most 65535 bytes each) followed by the Adler-32 checksum
+    std::vector<unsigned char> zlib = {0x78, 0x01};
+    zlib.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    size_t offset = 0;
+    do {
+        size_t length = std::min<size_t>(raw.size() - offset, 65535);
+        bool last = offset + length == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<unsigned char>(length));
+        zlib.push_back(static_cast<unsigned char>(length >> 8));
+        zlib.push_back(static_cast<unsigned char>(~length));
+        zlib.push_back(static_cast<unsigned char>(~length >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+        offset += length;
+    } while (offset < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (unsigned char byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    putBigEndian(zlib, (b << 16) | a);
+#endif
+
+    std::vector<unsigned char> header;
+    putBigEndian(header, static_cast<uint32_t>(width));
+    putBigEndian(header, static_cast<uint32_t>(height));
+    // 8 bits per channel, color type 6 (RGBA), default compression, filtering and no interlace
+    header.insert(header.end(), {8, 6, 0, 0, 0});
+
+    std::vector<unsigned char> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    putChunk(png, "IHDR", header);
+    putChunk(png, "IDAT", zlib);
+    putChunk(png, "IEND", {});
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,17 @@
+#ifndef GRAPHICS_PNGWRITER_H
+#define GRAPHICS_PNGWRITER_H
+
+#include <string>
+
+/// @brief Writes an 8-bit RGBA image to a PNG file
+/// @details The image data is deflated with zlib when the build found it (HAS_ZLIB). Otherwise it is stored
+/// uncompressed (deflate "stored" blocks): the files are much larger, but any PNG reader opens them.
+/// Compression runs on the calling thread, which is the recorder's worker for recorded frames.
+/// @param path The file to write
+/// @param width The width of the image in pixels
+/// @param height The height of the image in pixels
+/// @param rgba width * height * 4 bytes, rows bottom to top as glReadPixels returns them
+/// @return false if the file could not be written
+bool writePng(const std::string &path, int width, int height, const unsigned char *rgba);
+
+#endif //GRAPHICS_PNGWRITER_H
@@ -0,0 +1,210 @@
+#include "profiler.h"
+
+#ifdef ENABLE_PROFILER
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    struct ZoneEvent {
+        const char *name;
+        uint64_t start, end;
+    };
+
+    /// @brief Zones of one thread, written only by that thread
+    /// @details Readers copy an event and then check that the writer has not lapped it.
+    struct ThreadBuffer {
+        /// @brief Events kept per thread; a power of two
+        static const size_t capacity = 1 << 15;
+
+        ZoneEvent events[capacity];
+        std::atomic<size_t> head{0};
+        const char *name = nullptr;
+        int id = 0;
+        /// @brief Events before this were folded into the statistics (main thread only)
+        size_t consumed = 0;
+    };
+
+    /// @brief Per-frame times of a zone over the last historyFrames frames it ran in
+    struct ZoneStats {
+        static const int historyFrames = 240;
+
+        const char *name;
+        float samples[historyFrames];
+        int sampleCount = 0, next = 0;
+        /// @brief Time and calls in the frame being folded
+        uint64_t frameTime = 0;
+        int frameCalls = 0, lastCalls = 0;
+    };
+
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> threads;
+    uint64_t startTime = Profiler::now();
+
+    std::vector<ZoneStats> zones;
+    /// @brief Zone index by name pointer; the same text from different translation units is merged
+    std::unordered_map<const char *, size_t> zoneIndex;
+
+    ThreadBuffer *registerThread() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        threads.push_back(std::make_unique<ThreadBuffer>());
+        threads.back()->id = static_cast<int>(threads.size());
+        return threads.back().get();
+    }
+
+    ThreadBuffer &threadBuffer() {
+        static thread_local ThreadBuffer *buffer = registerThread();
+        return *buffer;
+    }
+
+    /// @brief The track GPU sections go on; written only by the GL thread
+    ThreadBuffer &gpuBuffer() {
+        static ThreadBuffer *buffer = [] {
+            ThreadBuffer *gpu = registerThread();
+            gpu->name = "GPU";
+            return gpu;
+        }();
+        return *buffer;
+    }
+
+    void push(ThreadBuffer &buffer, const char *name, uint64_t start, uint64_t end) {
+        const size_t head = buffer.head.load(std::memory_order_relaxed);
+        buffer.events[head & (ThreadBuffer::capacity - 1)] = {name, start, end};
+        buffer.head.store(head + 1, std::memory_order_release);
+    }
+
+    /// @brief Visits the events of a buffer from from to its head that the writer has not overwritten yet
+    /// @return The head the events were read up to
+    template<typename Visit>
+    size_t readEvents(const ThreadBuffer &buffer, size_t from, Visit visit) {
+        const size_t to = buffer.head.load(std::memory_order_acquire);
+        from = std::max(from, to > ThreadBuffer::capacity ? to - ThreadBuffer::capacity : size_t(0));
+        for (size_t i = from; i < to; ++i) {
+            ZoneEvent event = buffer.events[i & (ThreadBuffer::capacity - 1)];
+            // the writer may have wrapped around onto this slot while it was copied
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buffer.head.load(std::memory_order_relaxed) - i > ThreadBuffer::capacity)
+                continue;
+            visit(event);
+        }
+        return to;
+    }
+
+    size_t findZone(const char *name) {
+        auto found = zoneIndex.find(name);
+        if (found != zoneIndex.end())
+            return found->second;
+        size_t index = std::find_if(zones.begin(), zones.end(),
+                                    [name](const ZoneStats &zone) { return std::strcmp(zone.name, name) == 0; })
+                     - zones.begin();
+        if (index == zones.size()) {
+            zones.emplace_back();
+            zones.back().name = name;
+        }
+        zoneIndex.emplace(name, index);
+        return index;
+    }
+
+    /// @brief Returns the pth percentile (0-1) of a sorted list
+    float percentile(const std::vector<float> &sorted, float p) {
+        size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5f);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+}
+
+void Profiler::record(const char *name, uint64_t start, uint64_t end) {
+    push(threadBuffer(), name, start, end);
+}
+
+void Profiler::recordGpu(const char *name, uint64_t start, uint64_t end) {
+    push(gpuBuffer(), name, start, end);
+}
+
+void Profiler::setThreadName(const char *name) {
+    threadBuffer().name = name;
+}
+
+void Profiler::endFrame() {
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const std::unique_ptr<ThreadBuffer> &thread : threads) {
+            thread->consumed = readEvents(*thread, thread->consumed, [](const ZoneEvent &event) {
+                ZoneStats &zone = zones[findZone(event.name)];
+                zone.frameTime += event.end - event.start;
+                zone.frameCalls++;
+            });
+        }
+    }
+
+    // Zones that did not run this frame keep their history instead of recording a zero
+    for (ZoneStats &zone : zones) {
+        if (zone.frameCalls == 0)
+            continue;
+        zone.samples[zone.next] = static_cast<float>(zone.frameTime) * 1e-6f;
+        zone.next = (zone.next + 1) % ZoneStats::historyFrames;
+        zone.sampleCount = std::min(zone.sampleCount + 1, ZoneStats::historyFrames);
+        zone.lastCalls = zone.frameCalls;
+        zone.frameTime = 0;
+        zone.frameCalls = 0;
+    }
+}
+
+void Profiler::printStats() {
+    std::cout << "Zone times per frame over the last " << ZoneStats::historyFrames << " frames (ms):\n"
+              << std::left << std::setw(36) << "zone" << std::right << std::setw(8) << "calls"
+              << std::setw(10) << "p50" << std::setw(10) << "p95" << std::setw(10) << "p99" << "\n";
+    std::vector<float> sorted;
+    for (const ZoneStats &zone : zones) {
+        if (zone.sampleCount == 0)
+            continue;
+        sorted.assign(zone.samples, zone.samples + zone.sampleCount);
+        std::sort(sorted.begin(), sorted.end());
+        std::cout << std::left << std::setw(36) << zone.name << std::right << std::setw(8) << zone.lastCalls
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(10) << percentile(sorted, 0.50f)
+                  << std::setw(10) << percentile(sorted, 0.95f)
+                  << std::setw(10) << percentile(sorted, 0.99f) << "\n";
+    }
+    std::cout << std::defaultfloat << std::flush;
+}
+
+bool Profiler::writeTrace(const std::string &path) {
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file) {
+        std::cout << "ERROR::PROFILER: Failed to write " << path << std::endl;
+        return false;
+    }
+
+    // Complete ("X") events with microsecond timestamps, plus a name for every thread
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    size_t count = 0;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const std::unique_ptr<ThreadBuffer> &thread : threads) {
+        char fallbackName[32];
+        snprintf(fallbackName, sizeof(fallbackName), "thread %d", thread->id);
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", thread->id, thread->name ? thread->name : fallbackName);
+        first = false;
+
+        readEvents(*thread, 0, [&](const ZoneEvent &event) {
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    event.name, thread->id, (event.start - startTime) * 1e-3, (event.end - event.start) * 1e-3);
+            count++;
+        });
+    }
+    fprintf(file, "\n]}\n");
+    bool written = fclose(file) == 0;
+    std::cout << "Profiler: wrote " << count << " zones to " << path << std::endl;
+    return written;
+}
+
+#endif
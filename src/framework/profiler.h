@@ -0,0 +1,82 @@
+#ifndef GRAPHICS_PROFILER_H
+#define GRAPHICS_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/// @brief CPU frame profiler.
+/// @details Code is timed with PROFILE_ZONE("Name"), which records the time from the macro to the end of the
+/// enclosing scope. Every thread appends its zones to its own ring buffer without locking; endFrame() folds
+/// the new ones into rolling per-zone percentiles, and writeTrace() exports the buffers as a Chrome trace
+/// (open in chrome://tracing or ui.perfetto.dev).
+///
+/// Built when ENABLE_PROFILER is defined (the PROFILER CMake option). Without it PROFILE_ZONE expands to
+/// nothing and these functions are empty.
+class Profiler {
+public:
+    /// @brief Folds the zones finished since the last call into the per-zone statistics
+    /// @details Call once per frame from the main thread.
+    static void endFrame();
+
+    /// @brief Prints the 50th, 95th and 99th percentile time per frame of every zone
+    static void printStats();
+
+    /// @brief Writes the zones still in the ring buffers as Chrome trace JSON
+    /// @return false if the file could not be written
+    static bool writeTrace(const std::string &path);
+
+    /// @brief Names the calling thread in traces
+    /// @param name A string literal, or a string that outlives the profiler
+    static void setThreadName(const char *name);
+
+    /// @brief Nanoseconds on a monotonic clock
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// @brief Records a finished zone for the calling thread; used by PROFILE_ZONE
+    /// @param name A string literal
+    static void record(const char *name, uint64_t start, uint64_t end);
+
+    /// @brief Records a section of GPU work on the "GPU" track; used by GpuTimer
+    /// @details The times must already be on the now() clock. Call from the thread that owns the GL context.
+    static void recordGpu(const char *name, uint64_t start, uint64_t end);
+};
+
+#ifdef ENABLE_PROFILER
+
+/// @brief Records the time between its construction and destruction as a zone
+class ProfileZone {
+public:
+    explicit ProfileZone(const char *name) : name(name), start(Profiler::now()) {}
+    ~ProfileZone() { Profiler::record(name, start, Profiler::now()); }
+
+    ProfileZone(const ProfileZone &) = delete;
+    ProfileZone &operator=(const ProfileZone &) = delete;
+
+private:
+    const char *name;
+    uint64_t start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+/// @brief Times the rest of the enclosing scope; name must be a string literal
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+
+inline void Profiler::endFrame() {}
+inline void Profiler::printStats() {}
+inline bool Profiler::writeTrace(const std::string &) { return false; }
+inline void Profiler::setThreadName(const char *) {}
+inline void Profiler::record(const char *, uint64_t, uint64_t) {}
+inline void Profiler::recordGpu(const char *, uint64_t, uint64_t) {}
+
+#endif
+
+#endif //GRAPHICS_PROFILER_H
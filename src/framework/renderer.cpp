@@ -0,0 +1,101 @@
+#include "renderer.h"
+
+#include <algorithm>
+
+#include "allocationTracker.h"
+#include "profiler.h"
+
+Renderer::Renderer(ShaderManager &shaderManager, FontRenderer &fontRenderer) : Renderer(fontRenderer) {
+    spriteShader = shaderManager.getShader("sprite");
+    circleShader = shaderManager.getShader("circle");
+    particleShader = shaderManager.getShader("particle");
+}
+
+Renderer::Renderer(FontRenderer &fontRenderer) : fontRenderer(fontRenderer) {
+    // Room for a full level plus the overlay, so the first frames do not have to grow the buffers
+    commands.reserve(initialCapacity);
+    shapes.reserve(initialCapacity);
+    instances.reserve(initialCapacity);
+    particleSystems.reserve(4);
+}
+
+uint64_t Renderer::makeKey(RenderLayer layer, GLuint program, GLuint resource, uint32_t sequence) {
+    return (uint64_t(layer) << 56)
+         | (uint64_t(program & 0xFF) << 48)
+         | (uint64_t(resource & 0xFFFF) << 32)
+         | uint64_t(sequence);
+}
+
+void Renderer::submit(const Shape &shape, RenderLayer layer) {
+    // every mesh type has one VAO, so this groups the shapes by VAO without creating it
+    uint64_t key = makeKey(layer, shape.getShader().ID, static_cast<GLuint>(shape.getMeshType()), commands.size());
+    commands.push_back({key, Pipeline::Shape, static_cast<uint32_t>(shapes.size())});
+    shapes.push_back(&shape);
+}
+
+void Renderer::submit(const Circle &circle, RenderLayer layer) {
+    submitCircle(circle.getPos(), circle.getDrawRadius(), circle.getColor4(), layer);
+}
+
+void Renderer::submitCircle(vec2 center, float radius, vec4 color, RenderLayer layer) {
+    submitRoundedRect(center, vec2(radius * 2.0f), radius, color, layer);
+}
+
+void Renderer::submitRoundedRect(vec2 center, vec2 size, float cornerRadius, vec4 color, RenderLayer layer) {
+    // every instance uses the same program and resources, so only the layer and sequence matter
+    uint64_t key = makeKey(layer, circleShader.ID, 0, commands.size());
+    commands.push_back({key, Pipeline::Instance, static_cast<uint32_t>(instances.size())});
+    instances.push_back({center, size * 0.5f, color, cornerRadius});
+}
+
+void Renderer::submitSprite(GLuint texture, vec2 pos, vec2 size, vec3 color, RenderLayer layer) {
+    mat4 model = mat4(1.0f);
+    model = translate(model, vec3(pos, 1.0f));
+    model = scale(model, vec3(size, 1.0f));
+
+    uint64_t key = makeKey(layer, spriteShader.ID, texture, commands.size());
+    commands.push_back({key, Pipeline::Sprite, static_cast<uint32_t>(sprites.size())});
+    sprites.push_back({texture, model, color});
+}
+
+void Renderer::submitText(std::string_view text, float x, float y, float scale, vec3 color, RenderLayer layer) {
+    // All glyphs live in one atlas, so every text run in a layer ends up in the same batch
+    uint64_t key = makeKey(layer, fontRenderer.getShader().ID, fontRenderer.getAtlasTexture(), commands.size());
+    commands.push_back({key, Pipeline::Text, static_cast<uint32_t>(texts.size())});
+    texts.push_back({static_cast<uint32_t>(textBuffer.size()), static_cast<uint32_t>(text.size()), x, y, scale, color});
+    textBuffer += text;
+}
+
+void Renderer::submit(TextLayout &layout, RenderLayer layer) {
+    layout.update();
+    uint64_t key = makeKey(layer, fontRenderer.getShader().ID, fontRenderer.getAtlasTexture(), commands.size());
+    commands.push_back({key, Pipeline::Layout, static_cast<uint32_t>(layouts.size())});
+    layouts.push_back(&layout);
+}
+
+void Renderer::submit(const ParticleSystem &particles, RenderLayer layer) {
+    if (particles.size() == 0)
+        return;
+    uint64_t key = makeKey(layer, particleShader.ID, 0, commands.size());
+    commands.push_back({key, Pipeline::Particles, static_cast<uint32_t>(particleSystems.size())});
+    particleSystems.push_back(&particles);
+}
+
+void Renderer::flush() {
+    PROFILE_ZONE("Renderer::flush");
+    ALLOCATION_SCOPE("Renderer");
+    // The sequence number makes every key unique, so this keeps submission order for equal state
+    std::sort(commands.begin(), commands.end(),
+              [](const Command &a, const Command &b) { return a.key < b.key; });
+
+    execute();
+
+    commands.clear();
+    shapes.clear();
+    sprites.clear();
+    texts.clear();
+    layouts.clear();
+    instances.clear();
+    particleSystems.clear();
+    textBuffer.clear();
+}
@@ -0,0 +1,161 @@
+#ifndef GRAPHICS_RENDERER_H
+#define GRAPHICS_RENDERER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "shaderManager.h"
+#include "meshManager.h"
+#include "particleSystem.h"
+#include "../font/fontRenderer.h"
+#include "../font/textLayout.h"
+#include "../shapes/shape.h"
+#include "../shapes/circle.h"
+
+using std::vector, glm::vec2, glm::vec3, glm::vec4;
+
+/// @brief Draw order of submitted commands, lowest first.
+/// @details Commands in a lower layer are always drawn before commands in a higher layer;
+/// inside a layer they are sorted to minimize state changes.
+enum class RenderLayer : uint8_t { Background, Bricks, Actors, Text, Overlay };
+
+/// @brief Per-instance data of an analytic rounded box drawn by the "circle" program
+/// @details A circle is a box whose corner radius equals its half size.
+struct ShapeInstance {
+    vec2 center;
+    vec2 halfSize;
+    vec4 color;
+    float cornerRadius;
+};
+
+/// @brief Front-end for all drawing.
+/// @details Game code submits shapes, sprites and text runs during the frame. flush() sorts the
+/// commands by a 64-bit key (layer | program | VAO/texture | submission order) and hands them to the
+/// backend: GLRenderer replays them with OpenGL, SoftwareRenderer rasterizes them on the CPU.
+class Renderer {
+public:
+    /// @brief Construct a new Renderer
+    /// @param shaderManager Used to look up the "sprite", "circle" and "particle" programs
+    /// @param fontRenderer Used to lay out and replay text runs
+    Renderer(ShaderManager &shaderManager, FontRenderer &fontRenderer);
+
+    /// @brief Construct a new Renderer for a backend that draws without OpenGL
+    /// @details There are no programs, so commands are only sorted by layer, resource and submission order.
+    /// @param fontRenderer Used to lay out text runs
+    explicit Renderer(FontRenderer &fontRenderer);
+
+    virtual ~Renderer() = default;
+
+    /// @brief Queues a shape to be drawn with its own shader and mesh
+    /// @note The shape must stay alive until flush().
+    void submit(const Shape &shape, RenderLayer layer);
+
+    /// @brief Queues a circle as an instanced, antialiased quad
+    /// @details Drawn with the same size and color as Shape::draw() would.
+    void submit(const Circle &circle, RenderLayer layer);
+
+    /// @brief Queues a filled circle drawn with the "circle" program
+    /// @details Consecutive circles and rounded rects in a layer are drawn with one instanced draw call.
+    void submitCircle(vec2 center, float radius, vec4 color, RenderLayer layer);
+
+    /// @brief Queues a filled rectangle with rounded corners drawn with the "circle" program
+    /// @param center The center of the rectangle
+    /// @param size The width and height of the rectangle
+    /// @param cornerRadius The radius of the corners; 0 for sharp corners
+    void submitRoundedRect(vec2 center, vec2 size, float cornerRadius, vec4 color, RenderLayer layer);
+
+    /// @brief Queues a textured quad drawn with the "sprite" program
+    /// @param texture The texture to draw
+    /// @param pos The center of the sprite
+    /// @param size The size of the sprite
+    /// @param color Color the texture is multiplied with
+    void submitSprite(GLuint texture, vec2 pos, vec2 size, vec3 color, RenderLayer layer);
+
+    /// @brief Queues a run of text
+    /// @details The text is copied into a per-frame buffer, so temporaries and FixedString buffers may be passed.
+    void submitText(std::string_view text, float x, float y, float scale, vec3 color,
+                    RenderLayer layer = RenderLayer::Text);
+
+    /// @brief Queues a cached text layout, laying it out again first if it changed
+    /// @note The layout must stay alive until flush().
+    void submit(TextLayout &layout, RenderLayer layer = RenderLayer::Text);
+
+    /// @brief Queues every live particle of a system, drawn with the "particle" program in one instanced call
+    /// @note The system must stay alive and unchanged until flush().
+    void submit(const ParticleSystem &particles, RenderLayer layer);
+
+    /// @brief Makes room for drawing this many particles in a frame, so busy frames do not allocate
+    virtual void reserveParticles(size_t /*count*/) {}
+
+    /// @brief Starts or stops timing every layer on the GPU, for backends that can (profiler builds only)
+    virtual void setGpuTiming(bool /*enable*/) {}
+
+    /// @brief Fills the frame with a color
+    virtual void clear(vec4 color) = 0;
+
+    /// @brief Returns the last frame as RGBA bytes, bottom row first, if the backend draws it on the CPU
+    /// @return nullptr if the frame only exists in the GL framebuffer
+    virtual const unsigned char *getPixels() const { return nullptr; }
+
+    /// @brief Sorts and replays every queued command, then clears the queue
+    void flush();
+
+protected:
+    /// @brief How a command is replayed
+    enum class Pipeline : uint8_t { Shape, Sprite, Text, Layout, Instance, Particles };
+
+    /// @brief A queued draw; index points into the array for its pipeline
+    struct Command {
+        uint64_t key;
+        Pipeline pipeline;
+        uint32_t index;
+    };
+
+    struct SpriteDraw {
+        GLuint texture;
+        mat4 model;
+        vec3 color;
+    };
+
+    struct TextDraw {
+        uint32_t offset, length;
+        float x, y, scale;
+        vec3 color;
+    };
+
+    /// @brief Commands, shapes and instances reserved up front
+    static const size_t initialCapacity = 512;
+
+    /// @brief Builds a sort key: layer (8 bits) | program (8 bits) | resource (16 bits) | sequence (32 bits)
+    /// @details The resource is the texture of sprites and text, and the mesh type of shapes.
+    static uint64_t makeKey(RenderLayer layer, GLuint program, GLuint resource, uint32_t sequence);
+
+    /// @brief Draws the sorted commands; called by flush()
+    virtual void execute() = 0;
+
+    FontRenderer &fontRenderer;
+
+    /// @brief Program used for instanced shapes
+    Shader circleShader;
+
+    /// @brief Program used for sprites
+    Shader spriteShader;
+
+    /// @brief Program used for particles
+    Shader particleShader;
+
+    /// @brief The per-frame command buffer and the data it points into
+    /// @details Cleared (not freed) by flush(), so steady-state frames do not allocate.
+    vector<Command> commands;
+    vector<const Shape *> shapes;
+    vector<SpriteDraw> sprites;
+    vector<TextDraw> texts;
+    vector<const TextLayout *> layouts;
+    vector<ShapeInstance> instances;
+    vector<const ParticleSystem *> particleSystems;
+    std::string textBuffer;
+};
+
+#endif //GRAPHICS_RENDERER_H
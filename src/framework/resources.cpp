@@ -0,0 +1,56 @@
+#include "resources.h"
+#include "../util/mappedFile.h"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace {
+    std::string overrideDirectory;
+
+    /// @brief Guards overrides; resources are loaded from the startup worker threads too
+    std::mutex overridesMutex;
+
+    /// @brief Files mapped from the override directory, kept open so the views handed out stay valid
+    std::map<std::string, std::unique_ptr<MappedFile>, std::less<>> overrides;
+
+    std::string_view view(const unsigned char *data, size_t size) {
+        return {reinterpret_cast<const char *>(data), size};
+    }
+}
+
+void Resources::setOverrideDirectory(const std::string &directory) {
+    std::lock_guard<std::mutex> lock(overridesMutex);
+    overrideDirectory = directory;
+    overrides.clear();
+}
+
+std::string_view Resources::get(std::string_view name) {
+    std::unique_lock<std::mutex> lock(overridesMutex);
+    if (!overrideDirectory.empty()) {
+        auto found = overrides.find(name);
+        if (found == overrides.end()) {
+            auto file = std::make_unique<MappedFile>();
+            std::string path = overrideDirectory + "/" + std::string(name);
+            if (file->open(path))
+                std::cout << "Resources: using " << path << std::endl;
+            else
+                file.reset();
+            found = overrides.emplace(std::string(name), std::move(file)).first;
+        }
+        if (found->second)
+            return view(found->second->data(), found->second->size());
+    }
+    lock.unlock();
+
+    const EmbeddedResource *end = embeddedResources + embeddedResourceCount;
+    const EmbeddedResource *resource = std::lower_bound(embeddedResources, end, name,
+        [](const EmbeddedResource &entry, std::string_view key) { return std::string_view(entry.name) < key; });
+    if (resource == end || resource->name != name) {
+        std::cout << "ERROR::RESOURCES: No resource named " << name << std::endl;
+        return {};
+    }
+    return view(resource->data, resource->size);
+}
@@ -0,0 +1,38 @@
+#ifndef GRAPHICS_RESOURCES_H
+#define GRAPHICS_RESOURCES_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/// @brief A file compiled into the binary
+struct EmbeddedResource {
+    /// @brief Path relative to res/, e.g. "shaders/shape.vert"
+    const char *name;
+    /// @brief The contents, followed by a zero byte that is not part of size
+    const unsigned char *data;
+    size_t size;
+};
+
+/// @brief Every file under res/shaders and res/fonts, sorted by name
+/// @details Defined in the source cmake/embedResources.cmake generates at build time.
+extern const EmbeddedResource embeddedResources[];
+extern const size_t embeddedResourceCount;
+
+/// @brief Looks up the game's resources by their path relative to res/
+/// @details Shaders and fonts are embedded in the binary, so the game starts without opening any of them and
+/// from any working directory. For development an override directory can be set (--resources DIR): a file
+/// that exists there is used instead of the embedded copy, so shaders can be edited without rebuilding.
+class Resources {
+public:
+    /// @brief Sets the directory searched before the embedded resources; empty disables it
+    /// @details Call before loading anything: views of files from a previous override directory are released.
+    static void setOverrideDirectory(const std::string &directory);
+
+    /// @brief Returns the contents of a resource, which stay valid until exit
+    /// @details Prints an error and returns an empty view if there is no resource with that name.
+    /// Safe to call from any thread.
+    static std::string_view get(std::string_view name);
+};
+
+#endif //GRAPHICS_RESOURCES_H
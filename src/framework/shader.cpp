@@ -2,6 +2,7 @@
 
 Shader &Shader::use() {
     glUseProgram(this->ID);
+    glStats.stateChanges++;
     return *this;
 }
 
@@ -35,8 +36,12 @@ void Shader::compile(const char* vertexSource, const char* fragmentSource, const
     if (geometrySource != nullptr)
         glAttachShader(this->ID, gShader);
 
+    // ask for a binary the ShaderManager can cache
+    if (binariesSupported())
+        glProgramParameteri(this->ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(this->ID);
     checkCompileErrors(this->ID, "PROGRAM");
+    reflectUniforms();
 
     // delete the shaders as they're linked into our program now and no longer necessary
     glDeleteShader(sVertex);
@@ -45,41 +50,143 @@ void Shader::compile(const char* vertexSource, const char* fragmentSource, const
         glDeleteShader(gShader);
 }
 
+bool Shader::binariesSupported() {
+    static const bool supported = [] {
+        if (!GLAD_GL_VERSION_4_1 && !GLAD_GL_ARB_get_program_binary)
+            return false;
+        // drivers may support the calls but no format at all
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }();
+    return supported;
+}
+
+bool Shader::loadBinary(GLenum format, const void *binary, GLsizei length) {
+    this->ID = glCreateProgram();
+    glProgramBinary(this->ID, format, binary, length);
+    GLint linked = GL_FALSE;
+    glGetProgramiv(this->ID, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        glDeleteProgram(this->ID);
+        this->ID = 0;
+        return false;
+    }
+    reflectUniforms();
+    return true;
+}
+
+bool Shader::getBinary(GLenum &format, std::vector<unsigned char> &binary) const {
+    GLint linked = GL_FALSE, length = 0;
+    glGetProgramiv(this->ID, GL_LINK_STATUS, &linked);
+    glGetProgramiv(this->ID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (!linked || length <= 0)
+        return false;
+
+    binary.resize(length);
+    GLsizei written = 0;
+    glGetProgramBinary(this->ID, length, &written, &format, binary.data());
+    binary.resize(written);
+    return written > 0;
+}
+
+void Shader::reflectUniforms() {
+    uniformLocations.clear();
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(this->ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    string name(maxLength, '\0');
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(this->ID, i, maxLength, &length, &size, &type, &name[0]);
+        string uniformName = name.substr(0, length);
+
+        // Uniforms in a uniform block have no location
+        GLint location = glGetUniformLocation(this->ID, uniformName.c_str());
+        glStats.uniformLookups++;
+        if (location == -1)
+            continue;
+        uniformLocations[uniformName] = location;
+
+        // Arrays are reported as "name[0]"; also register them under "name"
+        if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+            uniformLocations[uniformName.substr(0, uniformName.size() - 3)] = location;
+    }
+}
+
+GLint Shader::getUniformLocation(const char *name) const {
+    auto it = uniformLocations.find(name);
+    return it != uniformLocations.end() ? it->second : -1;
+}
+
+void Shader::set(Uniform<float> uniform, float value) const {
+    glUniform1f(uniform.location, value);
+    glStats.uniformUploads++;
+}
+
+void Shader::set(Uniform<int> uniform, int value) const {
+    glUniform1i(uniform.location, value);
+    glStats.uniformUploads++;
+}
+
+void Shader::set(Uniform<glm::vec2> uniform, const glm::vec2 &value) const {
+    glUniform2f(uniform.location, value.x, value.y);
+    glStats.uniformUploads++;
+}
+
+void Shader::set(Uniform<glm::vec3> uniform, const glm::vec3 &value) const {
+    glUniform3f(uniform.location, value.x, value.y, value.z);
+    glStats.uniformUploads++;
+}
+
+void Shader::set(Uniform<glm::vec4> uniform, const glm::vec4 &value) const {
+    glUniform4f(uniform.location, value.x, value.y, value.z, value.w);
+    glStats.uniformUploads++;
+}
+
+void Shader::set(Uniform<glm::mat4> uniform, const glm::mat4 &matrix) const {
+    glUniformMatrix4fv(uniform.location, 1, false, glm::value_ptr(matrix));
+    glStats.uniformUploads++;
+}
+
 void Shader::setFloat(const char *name, float value) const {
-    glUniform1f(glGetUniformLocation(this->ID, name), value);
+    set(getUniform<float>(name), value);
 }
 
 void Shader::setInteger(const char *name, int value) const {
-    glUniform1i(glGetUniformLocation(this->ID, name), value);
-
+    set(getUniform<int>(name), value);
 }
 
 void Shader::setVector2f(const char *name, float x, float y) const {
-    glUniform2f(glGetUniformLocation(this->ID, name), x, y);
+    set(getUniform<glm::vec2>(name), glm::vec2(x, y));
 }
 
 void Shader::setVector2f(const char *name, const glm::vec2 &value) const {
-    glUniform2f(glGetUniformLocation(this->ID, name), value.x, value.y);
+    set(getUniform<glm::vec2>(name), value);
 }
 
 void Shader::setVector3f(const char *name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(this->ID, name), x, y, z);
+    set(getUniform<glm::vec3>(name), glm::vec3(x, y, z));
 }
 
 void Shader::setVector3f(const char *name, const glm::vec3 &value) const {
-    glUniform3f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z);
+    set(getUniform<glm::vec3>(name), value);
 }
 
 void Shader::setVector4f(const char *name, float x, float y, float z, float w) const {
-    glUniform4f(glGetUniformLocation(this->ID, name), x, y, z, w);
+    set(getUniform<glm::vec4>(name), glm::vec4(x, y, z, w));
 }
 
 void Shader::setVector4f(const char *name, const glm::vec4 &value) const {
-    glUniform4f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z, value.w);
+    set(getUniform<glm::vec4>(name), value);
 }
 
 void Shader::setMatrix4(const char *name, const glm::mat4 &matrix) const {
-    glUniformMatrix4fv(glGetUniformLocation(this->ID, name), 1, false, glm::value_ptr(matrix));
+    set(getUniform<glm::mat4>(name), matrix);
 }
 
 
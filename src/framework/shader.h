@@ -1,20 +1,33 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <map>
 #include <string>
+#include <functional>
+#include <vector>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include "glStats.h"
 using std::string, std::ifstream, std::stringstream, std::cout, std::endl;
 
+/// @brief A uniform location resolved once from a shader's uniform table.
+/// @details The type parameter selects the matching Shader::set overload, so hot paths
+/// can upload values without looking the uniform up by name.
+/// @note A location of -1 (uniform not active in the program) is silently ignored by OpenGL.
+template <typename T>
+struct Uniform {
+    GLint location = -1;
+};
+
 /// @brief General purpose shader object.
 /// @details Compiles from file, generates compile/link-time error messages and hosts several utility functions for easy management.
 class Shader {
     public:
-        /// @brief The shader program ID
-        unsigned int ID;
+        /// @brief The shader program ID (0 until compiled)
+        unsigned int ID = 0;
 
         /// @brief Construct a new Shader object
         Shader() { }
@@ -31,9 +44,50 @@ class Shader {
         /// @param geometrySource the source code for the geometry shader (optional)
         void compile(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr); // note: geometry source code is optional
 
+        /// @brief Loads the program from a binary returned by getBinary()
+        /// @details Skips compiling and linking entirely. Fails if the driver no longer accepts the binary,
+        /// e.g. after a driver update; the shader is left without a program then.
+        /// @param format The binary format getBinary() reported
+        /// @param binary The binary
+        /// @param length Size of the binary in bytes
+        /// @return true if the program was loaded and linked
+        bool loadBinary(GLenum format, const void *binary, GLsizei length);
+
+        /// @brief Retrieves the linked program as a driver specific binary, for loadBinary() in a later run
+        /// @param format Receives the binary format
+        /// @param binary Receives the binary
+        /// @return false if the program is not linked or the driver cannot provide a binary
+        bool getBinary(GLenum &format, std::vector<unsigned char> &binary) const;
+
+        /// @brief Returns true if the driver can save and load program binaries (GL 4.1 or ARB_get_program_binary)
+        static bool binariesSupported();
+
+        /// @brief Returns the location of an active uniform from the table built in compile()
+        /// @param name name of the uniform
+        /// @return the location, or -1 if the program has no active uniform with that name
+        GLint getUniformLocation(const char *name) const;
+
+        /// @brief Resolves a typed handle for an active uniform
+        /// @details Resolve handles once (e.g. in a constructor) and pass them to set() on the hot path.
+        /// @param name name of the uniform
+        template <typename T>
+        Uniform<T> getUniform(const char *name) const { return Uniform<T>{getUniformLocation(name)}; }
+
+        // ------------------------------------------------------------------------
+        // handle based setters (no lookup)
+        // ------------------------------------------------------------------------
+
+        void set(Uniform<float> uniform, float value) const;
+        void set(Uniform<int> uniform, int value) const;
+        void set(Uniform<glm::vec2> uniform, const glm::vec2 &value) const;
+        void set(Uniform<glm::vec3> uniform, const glm::vec3 &value) const;
+        void set(Uniform<glm::vec4> uniform, const glm::vec4 &value) const;
+        void set(Uniform<glm::mat4> uniform, const glm::mat4 &matrix) const;
+
         // ------------------------------------------------------------------------
         // utility functions
         // ------------------------------------------------------------------------
+        // These look the uniform up by name in the uniform table; prefer Uniform handles on hot paths.
 
         /// @brief set a uniform float in the shader
         /// @param name name of the uniform
@@ -90,6 +144,13 @@ class Shader {
         void setMatrix4(const char *name, const glm::mat4 &matrix) const;
 
     private:
+        /// @brief Active uniform locations by name, filled by reflectUniforms() after linking
+        /// @details std::less<> allows lookups by const char * without building a std::string.
+        std::map<std::string, GLint, std::less<>> uniformLocations;
+
+        /// @brief Queries every active uniform of the linked program with glGetActiveUniform
+        void reflectUniforms();
+
         /// @brief Checks if compilation or linking failed and if so, print the error logs
         /// @param object the shader object to check
         /// @param type the type of shader object (vertex, fragment, geometry)
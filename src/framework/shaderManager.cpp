@@ -1,5 +1,46 @@
 #include "shaderManager.h"
+#include "allocationTracker.h"
+#include "profiler.h"
+#include "resources.h"
+#include "../util/cacheDirectory.h"
+#include "../util/hash.h"
+#include "../util/mappedFile.h"
 
+#include <cstring>
+#include <filesystem>
+
+namespace {
+    /// @brief Layout of the start of a program cache file, followed by the binary
+    struct CacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t format;
+        uint32_t length;
+    };
+
+    const char cacheMagic[4] = {'P', 'R', 'G', 'C'};
+    // bump when the file layout or the way programs are built changes
+    const uint32_t cacheVersion = 1;
+
+    /// @brief Hashes a string with its length, so consecutive strings cannot run into each other
+    uint64_t hashString(const std::string &text, uint64_t seed) {
+        const uint64_t length = text.size();
+        return fnv1a(text.data(), text.size(), fnv1a(&length, sizeof(length), seed));
+    }
+}
+
+ShaderManager::ShaderManager() {
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+
+    // Binaries only load on the driver that wrote them, so it is part of every key
+    if (Shader::binariesSupported()) {
+        driverKey = fnv1a(&cacheVersion, sizeof(cacheVersion));
+        for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+            const char *value = reinterpret_cast<const char *>(glGetString(name));
+            driverKey = hashString(value ? value : "", driverKey);
+        }
+    }
+}
 
 ShaderManager::~ShaderManager() {
     clear();
@@ -7,10 +48,28 @@ ShaderManager::~ShaderManager() {
 
 Shader ShaderManager::loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile,
                                  std::string name) {
-    shaders[name] = loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile);
+    shaders[name] = loadShaderFromResources(vShaderFile, fShaderFile, gShaderFile);
+    bindFrameBlock(shaders[name]);
     return shaders[name];
 }
 
+void ShaderManager::bindFrameBlock(const Shader &shader) {
+    GLuint blockIndex = glGetUniformBlockIndex(shader.ID, "FrameData");
+    if (blockIndex != GL_INVALID_INDEX)
+        glUniformBlockBinding(shader.ID, blockIndex, frameBinding);
+}
+
+void ShaderManager::updateFrameUniforms(const FrameUniforms &frame, StreamBuffer &streamBuffer) {
+    PROFILE_ZONE("ShaderManager::updateFrameUniforms");
+    ALLOCATION_SCOPE("Shaders");
+    GLintptr offset = streamBuffer.upload(&frame, sizeof(FrameUniforms), uniformAlignment);
+    if (offset < 0)
+        return;
+    // Every program's FrameData block reads from this range until the next frame
+    glBindBufferRange(GL_UNIFORM_BUFFER, frameBinding, streamBuffer.getBuffer(), offset, sizeof(FrameUniforms));
+    glStats.stateChanges++;
+}
+
 Shader& ShaderManager::getShader(std::string name) {
     return shaders[name];
 }
@@ -22,42 +81,95 @@ void ShaderManager::clear() {
         glDeleteProgram(iter.second.ID);
 }
 
-Shader ShaderManager::loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile) {
-    // 1. retrieve the vertex/fragment source code from filePath
-    std::string vertexCode;
-    std::string fragmentCode;
+Shader ShaderManager::loadShaderFromResources(const char *vShaderFile, const char *fShaderFile,
+                                              const char *gShaderFile) {
+    PROFILE_ZONE("ShaderManager::loadShader");
+    // 1. retrieve the vertex/fragment source code from the embedded resources
+    std::string vertexCode(Resources::get(vShaderFile));
+    std::string fragmentCode(Resources::get(fShaderFile));
+    // if a geometry shader is given, also load a geometry shader
     std::string geometryCode;
-    try {
-        // open files
-        std::ifstream vertexShaderFile(vShaderFile);
-        std::ifstream fragmentShaderFile(fShaderFile);
-        std::stringstream vShaderStream, fShaderStream;
-        // read file's buffer contents into streams
-        vShaderStream << vertexShaderFile.rdbuf();
-        fShaderStream << fragmentShaderFile.rdbuf();
-        // close file handlers
-        vertexShaderFile.close();
-        fragmentShaderFile.close();
-        // convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-        // if geometry shader path is present, also load a geometry shader
-        if (gShaderFile != nullptr) {
-            std::ifstream geometryShaderFile(gShaderFile);
-            std::stringstream gShaderStream;
-            gShaderStream << geometryShaderFile.rdbuf();
-            geometryShaderFile.close();
-            geometryCode = gShaderStream.str();
-        }
+    if (gShaderFile != nullptr)
+        geometryCode = Resources::get(gShaderFile);
+    // 2. now create shader object from source code (or from the cached binary of the same code)
+    return buildProgram(vertexCode, fragmentCode, gShaderFile != nullptr ? &geometryCode : nullptr);
+}
+
+Shader ShaderManager::buildProgram(const std::string &vertexCode, const std::string &fragmentCode,
+                                   const std::string *geometryCode) {
+    Shader shader;
+    std::string cachePath;
+    if (driverKey != 0) {
+        cachePath = getCachePath(vertexCode, fragmentCode, geometryCode);
+        if (loadCache(cachePath, shader))
+            return shader;
     }
-    catch (std::exception& e) {
-        std::cout << "ERROR::SHADER: Failed to read shader files" << std::endl;
+
+    {
+        PROFILE_ZONE("ShaderManager::compile");
+        shader.compile(vertexCode.c_str(), fragmentCode.c_str(), geometryCode ? geometryCode->c_str() : nullptr);
     }
-    const char *vShaderCode = vertexCode.c_str();
-    const char *fShaderCode = fragmentCode.c_str();
-    const char *gShaderCode = geometryCode.c_str();
-    // 2. now create shader object from source code
-    Shader shader;
-    shader.compile(vShaderCode, fShaderCode, gShaderFile != nullptr ? gShaderCode : nullptr);
+    if (driverKey != 0)
+        saveCache(cachePath, shader);
     return shader;
+}
+
+std::string ShaderManager::getCachePath(const std::string &vertexCode, const std::string &fragmentCode,
+                                        const std::string *geometryCode) const {
+    uint64_t key = hashString(vertexCode, driverKey);
+    key = hashString(fragmentCode, key);
+    key = hashString(geometryCode ? *geometryCode : std::string(), key);
+
+    char name[64];
+    snprintf(name, sizeof(name), "program-%016llx.bin", static_cast<unsigned long long>(key));
+    return cacheDirectory() + "/" + name;
+}
+
+bool ShaderManager::loadCache(const std::string &cachePath, Shader &shader) const {
+    PROFILE_ZONE("ShaderManager::loadCache");
+    MappedFile file;
+    if (!file.open(cachePath) || file.size() < sizeof(CacheHeader))
+        return false;
+
+    CacheHeader header{};
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion
+        || file.size() != sizeof(header) + header.length) {
+        std::cout << "ERROR::SHADER: Ignoring invalid program cache " << cachePath << std::endl;
+        return false;
+    }
+    // a driver may still refuse a binary it wrote, e.g. after an update that kept its version string
+    return shader.loadBinary(header.format, file.data() + sizeof(header), static_cast<GLsizei>(header.length));
+}
+
+void ShaderManager::saveCache(const std::string &cachePath, const Shader &shader) const {
+    GLenum format = 0;
+    std::vector<unsigned char> binary;
+    if (!shader.getBinary(format, binary))
+        return;
+
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory(), error);
+
+    // write to a temporary file first, so an interrupted write never leaves a broken cache behind
+    std::string tempPath = cachePath + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary);
+    if (!out) {
+        std::cout << "ERROR::SHADER: Failed to write program cache " << cachePath << std::endl;
+        return;
+    }
+
+    CacheHeader header{};
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = cacheVersion;
+    header.format = format;
+    header.length = static_cast<uint32_t>(binary.size());
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(binary.data()), static_cast<std::streamsize>(binary.size()));
+    out.close();
+
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        std::cout << "ERROR::SHADER: Failed to write program cache " << cachePath << std::endl;
+    }
 }
\ No newline at end of file
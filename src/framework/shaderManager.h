@@ -2,6 +2,7 @@
 #define GRAPHICS_SHADERMANAGER_H
 
 #include "shader.h"
+#include "streamBuffer.h"
 
 #include <map>
 #include <string>
@@ -9,19 +10,40 @@
 #include <fstream>
 #include <sstream>
 
+/// @brief Frame-global uniform data shared by every program through the FrameData uniform block.
+/// @details Laid out to match std140: mat4 (64 bytes), vec4 (16 bytes), float padded to a vec4.
+struct FrameUniforms {
+    /// @brief Orthographic projection of the window
+    glm::mat4 projection;
+    /// @brief x, y, width, height of the viewport in pixels
+    glm::vec4 viewport;
+    /// @brief Seconds since the engine started
+    float time;
+    float padding[3];
+};
+
+/// @brief Loads, stores and shares the shader programs
+/// @details Linked programs are kept as driver binaries in the cacheDirectory(), keyed by a hash of their sources and
+/// the driver's vendor, renderer and version strings. Later runs load them with glProgramBinary instead of
+/// compiling and linking; a binary the driver rejects is rebuilt from source and replaced.
 class ShaderManager {
 public:
-    /// @brief Default constructor
-    ShaderManager() = default;
+    /// @brief Binding point of the FrameData uniform block in every program
+    static const GLuint frameBinding = 0;
+
+    /// @brief Constructor
+    /// @details Queries the uniform buffer offset alignment and the driver strings (requires a current OpenGL
+    /// context).
+    ShaderManager();
     /// @brief Default destructor
     /// @details Clears the shaders map
     ~ShaderManager();
 
 
-    /// @brief Calls loadShaderFromFile() and stores the shader in the shaders map
-    /// @param vShaderFile The vertex shader file
-    /// @param fShaderFile The fragment shader file
-    /// @param gShaderFile The geometry shader file (optional)
+    /// @brief Calls loadShaderFromResources() and stores the shader in the shaders map
+    /// @param vShaderFile The vertex shader resource, e.g. "shaders/shape.vert"
+    /// @param fShaderFile The fragment shader resource
+    /// @param gShaderFile The geometry shader resource (optional)
     /// @param name Name used for the shader in the shaders map
     /// @return The shader that was loaded
     Shader loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name);
@@ -34,17 +56,47 @@ public:
      /// @brief Clears the shaders map
     void clear();
 
+    /// @brief Uploads the frame-global uniforms once for all programs
+    /// @details Call once per frame before drawing. The data is written to this frame's segment of
+    /// the stream buffer, which is then bound to frameBinding.
+    void updateFrameUniforms(const FrameUniforms &frame, StreamBuffer &streamBuffer);
+
 private:
     /// @brief A map of shaders, with the key being the name of the shader
     std::map<std::string, Shader> shaders;
 
-     /// @brief Loads and compiles a shader from a file
+    /// @brief GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, required for glBindBufferRange offsets
+    GLint uniformAlignment = 256;
+
+    /// @brief Hash of the driver strings, the start of every cache key; 0 if binaries are not supported
+    uint64_t driverKey = 0;
+
+    /// @brief Connects the FrameData block of a program (if it has one) to frameBinding
+    void bindFrameBlock(const Shader &shader);
+
+     /// @brief Loads and compiles a shader from the resources embedded in the binary (see Resources)
      /// @details This function is private because we only want to load shaders from within this class
-     /// @param vShaderFile The vertex shader file
-     /// @param fShaderFile The fragment shader file
-     /// @param gShaderFile The geometry shader file (optional)
+     /// @param vShaderFile The vertex shader resource
+     /// @param fShaderFile The fragment shader resource
+     /// @param gShaderFile The geometry shader resource (optional)
      /// @return The shader that was loaded
-    Shader loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile=nullptr);
+    Shader loadShaderFromResources(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile=nullptr);
+
+    /// @brief Loads a program from the cache, or compiles it and adds it to the cache
+    /// @param geometryCode The geometry shader source, or nullptr
+    Shader buildProgram(const std::string &vertexCode, const std::string &fragmentCode,
+                        const std::string *geometryCode);
+
+    /// @brief Builds the cache file name from the driver and the sources of a program
+    std::string getCachePath(const std::string &vertexCode, const std::string &fragmentCode,
+                             const std::string *geometryCode) const;
+
+    /// @brief Loads a program from a cache file
+    /// @return false if there is no usable binary
+    bool loadCache(const std::string &cachePath, Shader &shader) const;
+
+    /// @brief Writes the binary of a linked program to a cache file
+    void saveCache(const std::string &cachePath, const Shader &shader) const;
 };
 
 #endif //GRAPHICS_SHADERMANAGER_H
@@ -0,0 +1,482 @@
+#include "softwareRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "profiler.h"
+
+namespace {
+    /// @brief Blends a primitive into the rows [y0, y1) and columns [x0, x1) of a tile, four pixels at a time
+    /// @details Matches glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) on every channel, alpha included.
+    /// x0 must be a multiple of 4; the last group may run past x1, where the coverage is expected to be 0.
+    /// @param coverage Returns the coverage of four pixels given their centers
+    template<typename Coverage>
+    void blend(float *r, float *g, float *b, float *a, int stride, int tileX, int tileY,
+               int x0, int x1, int y0, int y1, vec4 color, Coverage coverage) {
+        const Float4 red(color.x), green(color.y), blue(color.z), alpha(color.w);
+        const Float4 lanes(0.5f, 1.5f, 2.5f, 3.5f);
+        for (int y = y0; y < y1; ++y) {
+            const float py = static_cast<float>(tileY + y) + 0.5f;
+            for (int x = x0; x < x1; x += 4) {
+                Float4 weight = coverage(Float4(static_cast<float>(tileX + x)) + lanes, py);
+                if (!any(weight >= Float4(1.0f / 512.0f)))
+                    continue;
+                weight = weight * alpha;
+
+                const int i = y * stride + x;
+                Float4 dr = Float4::load(r + i), dg = Float4::load(g + i), db = Float4::load(b + i);
+                Float4 da = Float4::load(a + i);
+                (dr + (red - dr) * weight).store(r + i);
+                (dg + (green - dg) * weight).store(g + i);
+                (db + (blue - db) * weight).store(b + i);
+                (da + (weight - da) * weight).store(a + i);
+            }
+        }
+    }
+
+    /// @brief Samples an atlas page with bilinear filtering and clamp-to-edge, like GL_LINEAR
+    float sampleAtlas(const unsigned char *page, float u, float v) {
+        const float sx = u * Font::atlasWidth - 0.5f, sy = v * Font::pageHeight - 0.5f;
+        const float fx = std::floor(sx), fy = std::floor(sy);
+        const float tx = sx - fx, ty = sy - fy;
+        const int x0 = std::clamp(static_cast<int>(fx), 0, Font::atlasWidth - 1);
+        const int x1 = std::clamp(static_cast<int>(fx) + 1, 0, Font::atlasWidth - 1);
+        const int y0 = std::clamp(static_cast<int>(fy), 0, Font::pageHeight - 1);
+        const int y1 = std::clamp(static_cast<int>(fy) + 1, 0, Font::pageHeight - 1);
+        const unsigned char *row0 = page + y0 * Font::atlasWidth, *row1 = page + y1 * Font::atlasWidth;
+        const float top = row0[x0] + (row0[x1] - row0[x0]) * tx;
+        const float bottom = row1[x0] + (row1[x1] - row1[x0]) * tx;
+        return (top + (bottom - top) * ty) * (1.0f / 255.0f);
+    }
+}
+
+SoftwareRenderer::SoftwareRenderer(ShaderManager &shaderManager, FontRenderer &fontRenderer, int width, int height)
+    : Renderer(shaderManager, fontRenderer), width(width), height(height) {
+    start();
+
+    // The frame is uploaded to a texture and blitted from a framebuffer it is attached to
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLint boundFramebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &boundFramebuffer);
+    glGenFramebuffers(1, &readFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, readFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, boundFramebuffer);
+}
+
+SoftwareRenderer::SoftwareRenderer(FontRenderer &fontRenderer, int width, int height)
+    : Renderer(fontRenderer), width(width), height(height) {
+    start();
+}
+
+void SoftwareRenderer::start() {
+    tilesX = (width + tileSize - 1) / tileSize;
+    tilesY = (height + tileSize - 1) / tileSize;
+    framebuffer.resize(size_t(width) * height * 4);
+    binStarts.resize(tilesX * tilesY + 1);
+    binCursors.resize(tilesX * tilesY);
+    // Glyphs are primitives too, so text heavy screens need a few per character
+    primitives.reserve(4 * initialCapacity);
+    binEntries.reserve(tilesX * tilesY * initialCapacity / 8);
+
+    // The calling thread rasterizes too, so one worker fewer than there are cores
+    int workerCount = std::clamp(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0, maxWorkers);
+    for (int i = 0; i <= workerCount; ++i) {
+        tileBuffers.push_back(std::make_unique<TileBuffer>());
+    }
+    for (int i = 1; i <= workerCount; ++i) {
+        workers.emplace_back(&SoftwareRenderer::workerLoop, this, i);
+    }
+}
+
+SoftwareRenderer::~SoftwareRenderer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    startWork.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    if (texture != 0) {
+        glDeleteFramebuffers(1, &readFramebuffer);
+        glDeleteTextures(1, &texture);
+    }
+}
+
+void SoftwareRenderer::clear(vec4 color) {
+    clearColor = color;
+}
+
+const unsigned char *SoftwareRenderer::getPixels() const {
+    return framebuffer.data();
+}
+
+void SoftwareRenderer::addPrimitive(Primitive primitive, float minX, float minY, float maxX, float maxY) {
+    // a pixel is covered when its center is, as in GL rasterization
+    primitive.x0 = std::max(0, static_cast<int>(std::ceil(minX - 0.5f)));
+    primitive.y0 = std::max(0, static_cast<int>(std::ceil(minY - 0.5f)));
+    primitive.x1 = std::min(width, static_cast<int>(std::ceil(maxX - 0.5f)));
+    primitive.y1 = std::min(height, static_cast<int>(std::ceil(maxY - 0.5f)));
+    if (primitive.x0 >= primitive.x1 || primitive.y0 >= primitive.y1 || primitive.color.w <= 0.0f)
+        return;
+    primitives.push_back(primitive);
+}
+
+void SoftwareRenderer::addShape(const Shape &shape) {
+    const mat4 model = shape.getModelMatrix();
+    const vec2 center(model[3]);
+    Primitive primitive{};
+    primitive.color = shape.getColor4();
+
+    switch (shape.getMeshType()) {
+        case MeshType::Quad: {
+            // The unit quad spans -0.5 to 0.5; without rotation it is a box
+            if (model[0][1] == 0.0f && model[1][0] == 0.0f) {
+                const vec2 half = glm::abs(vec2(model[0][0], model[1][1])) * 0.5f;
+                primitive.kind = PrimitiveKind::Box;
+                primitive.a = center - half;
+                primitive.b = center + half;
+                addPrimitive(primitive, primitive.a.x, primitive.a.y, primitive.b.x, primitive.b.y);
+                return;
+            }
+            const vec2 corners[4] = {vec2(model * vec4(-0.5f, -0.5f, 0.0f, 1.0f)),
+                                     vec2(model * vec4(0.5f, -0.5f, 0.0f, 1.0f)),
+                                     vec2(model * vec4(0.5f, 0.5f, 0.0f, 1.0f)),
+                                     vec2(model * vec4(-0.5f, 0.5f, 0.0f, 1.0f))};
+            primitive.kind = PrimitiveKind::Triangle;
+            for (int i = 0; i < 2; ++i) {
+                primitive.a = corners[0];
+                primitive.b = corners[1 + i];
+                primitive.c = corners[2 + i];
+                vec2 lo = glm::min(primitive.a, glm::min(primitive.b, primitive.c));
+                vec2 hi = glm::max(primitive.a, glm::max(primitive.b, primitive.c));
+                addPrimitive(primitive, lo.x, lo.y, hi.x, hi.y);
+            }
+            return;
+        }
+        case MeshType::Circle: {
+            // The unit circle has a radius of 1; drawn antialiased, like the instanced circles
+            const vec2 half = glm::abs(vec2(model[0][0], model[1][1]));
+            primitive.kind = PrimitiveKind::RoundedBox;
+            primitive.a = center;
+            primitive.b = half;
+            primitive.cornerRadius = std::min(half.x, half.y);
+            addPrimitive(primitive, center.x - half.x - 1, center.y - half.y - 1,
+                         center.x + half.x + 1, center.y + half.y + 1);
+            return;
+        }
+        case MeshType::Triangle: {
+            primitive.kind = PrimitiveKind::Triangle;
+            primitive.a = vec2(model * vec4(-0.5f, -0.5f, 0.0f, 1.0f));
+            primitive.b = vec2(model * vec4(0.5f, -0.5f, 0.0f, 1.0f));
+            primitive.c = vec2(model * vec4(0.0f, 0.5f, 0.0f, 1.0f));
+            vec2 lo = glm::min(primitive.a, glm::min(primitive.b, primitive.c));
+            vec2 hi = glm::max(primitive.a, glm::max(primitive.b, primitive.c));
+            addPrimitive(primitive, lo.x, lo.y, hi.x, hi.y);
+            return;
+        }
+        case MeshType::Count:
+            return;
+    }
+}
+
+void SoftwareRenderer::addGlyphs(const GlyphVertex *vertices, size_t count) {
+    const bool sdf = fontRenderer.getMode() == FontMode::SDF;
+    // FontRenderer::layout() emits 6 vertices per glyph; the second is the bottom left corner
+    // and the last the top right one
+    for (size_t i = 0; i + 6 <= count; i += 6) {
+        const GlyphVertex &bottomLeft = vertices[i + 1], &topRight = vertices[i + 5];
+        Primitive primitive{};
+        primitive.kind = PrimitiveKind::Glyph;
+        primitive.color = vec4(bottomLeft.color[0], bottomLeft.color[1], bottomLeft.color[2], bottomLeft.color[3])
+                        * (1.0f / 255.0f);
+        primitive.a = vec2(bottomLeft.x, bottomLeft.y);
+        primitive.b = vec2(topRight.x, topRight.y);
+        primitive.uv = vec4(bottomLeft.u, bottomLeft.v, topRight.u, topRight.v);
+        primitive.page = static_cast<unsigned int>(bottomLeft.page);
+        if (sdf && primitive.b.x > primitive.a.x) {
+            // textSdf.frag smooths over 0.7 * fwidth(dist). The field changes by 1 / (2 * spread) per raster
+            // pixel; fwidth adds up both axes, which is the gradient itself on axis aligned edges
+            float texelsPerPixel = (primitive.uv.z - primitive.uv.x) * Font::atlasWidth
+                                 / (primitive.b.x - primitive.a.x);
+            primitive.smoothing = 0.7f * texelsPerPixel / (2.0f * Font::sdfSpread);
+        }
+        addPrimitive(primitive, primitive.a.x, primitive.a.y, primitive.b.x, primitive.b.y);
+    }
+}
+
+void SoftwareRenderer::reserveParticles(size_t count) {
+    // A dot is at most a few pixels wide, so it lands in at most four tiles
+    primitives.reserve(4 * initialCapacity + count);
+    binEntries.reserve(tilesX * tilesY * initialCapacity / 8 + 4 * count);
+}
+
+void SoftwareRenderer::addParticles(const ParticleSystem &particles) {
+    const float *posX = particles.getPosX(), *posY = particles.getPosY(), *life = particles.getLife();
+    const uint32_t *colors = particles.getColors();
+    for (size_t i = 0; i < particles.size(); ++i) {
+        // the same dot as particle.vert: shrinking and fading out over the particle's life
+        const float radius = 0.5f * ParticleSystem::particleSize * life[i];
+        const uint32_t packed = colors[i];
+        Primitive primitive{};
+        primitive.kind = PrimitiveKind::RoundedBox;
+        primitive.color = vec4((packed & 0xFF) / 255.0f, (packed >> 8 & 0xFF) / 255.0f,
+                               (packed >> 16 & 0xFF) / 255.0f, (packed >> 24) / 255.0f * life[i]);
+        primitive.a = vec2(posX[i], posY[i]);
+        primitive.b = vec2(radius);
+        primitive.cornerRadius = radius;
+        addPrimitive(primitive, posX[i] - radius - 1.0f, posY[i] - radius - 1.0f,
+                     posX[i] + radius + 1.0f, posY[i] + radius + 1.0f);
+    }
+}
+
+void SoftwareRenderer::execute() {
+    PROFILE_ZONE("SoftwareRenderer::execute");
+    primitives.clear();
+
+    for (const Command &command : commands) {
+        switch (command.pipeline) {
+            case Pipeline::Shape: {
+                addShape(*shapes[command.index]);
+                break;
+            }
+            case Pipeline::Sprite: {
+                if (!warnedSprites) {
+                    std::cout << "ERROR::RENDERER: Sprites are not drawn by the software renderer" << std::endl;
+                    warnedSprites = true;
+                }
+                break;
+            }
+            case Pipeline::Text: {
+                const TextDraw &text = texts[command.index];
+                glyphScratch.clear();
+                fontRenderer.layout(textBuffer.data() + text.offset, text.length, text.x, text.y, text.scale,
+                                    text.color, glyphScratch);
+                addGlyphs(glyphScratch.data(), glyphScratch.size());
+                break;
+            }
+            case Pipeline::Layout: {
+                const vector<GlyphVertex> &vertices = layouts[command.index]->getVertices();
+                addGlyphs(vertices.data(), vertices.size());
+                break;
+            }
+            case Pipeline::Instance: {
+                const ShapeInstance &instance = instances[command.index];
+                Primitive primitive{};
+                primitive.kind = PrimitiveKind::RoundedBox;
+                primitive.color = instance.color;
+                primitive.a = instance.center;
+                primitive.b = instance.halfSize;
+                primitive.cornerRadius = instance.cornerRadius;
+                // one extra pixel for the antialiased edge
+                const vec2 lo = instance.center - instance.halfSize - vec2(1.0f);
+                const vec2 hi = instance.center + instance.halfSize + vec2(1.0f);
+                addPrimitive(primitive, lo.x, lo.y, hi.x, hi.y);
+                break;
+            }
+            case Pipeline::Particles: {
+                addParticles(*particleSystems[command.index]);
+                break;
+            }
+        }
+    }
+
+    // Bin the primitives with a counting sort into one array: count per tile, then place every primitive
+    // after the bins before its tile. Each bin keeps draw order.
+    std::fill(binStarts.begin(), binStarts.end(), 0);
+    for (const Primitive &primitive : primitives) {
+        for (int ty = primitive.y0 / tileSize; ty <= (primitive.y1 - 1) / tileSize; ++ty) {
+            for (int tx = primitive.x0 / tileSize; tx <= (primitive.x1 - 1) / tileSize; ++tx) {
+                binStarts[ty * tilesX + tx + 1]++;
+            }
+        }
+    }
+    for (size_t tile = 1; tile < binStarts.size(); ++tile) {
+        binStarts[tile] += binStarts[tile - 1];
+    }
+    binEntries.resize(binStarts.back());
+    std::copy(binStarts.begin(), binStarts.end() - 1, binCursors.begin());
+    for (uint32_t i = 0; i < primitives.size(); ++i) {
+        const Primitive &primitive = primitives[i];
+        for (int ty = primitive.y0 / tileSize; ty <= (primitive.y1 - 1) / tileSize; ++ty) {
+            for (int tx = primitive.x0 / tileSize; tx <= (primitive.x1 - 1) / tileSize; ++tx) {
+                binEntries[binCursors[ty * tilesX + tx]++] = i;
+            }
+        }
+    }
+
+    // Hand the tiles to the workers and take a share of them on this thread
+    nextTile = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        busyWorkers = static_cast<int>(workers.size());
+        workGeneration++;
+    }
+    startWork.notify_all();
+    rasterizeTiles(*tileBuffers[0]);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        workDone.wait(lock, [this] { return busyWorkers == 0; });
+    }
+
+    if (texture != 0)
+        present();
+}
+
+void SoftwareRenderer::workerLoop(int index) {
+    Profiler::setThreadName("software raster");
+    unsigned int seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            startWork.wait(lock, [&] { return stopping || workGeneration != seenGeneration; });
+            if (stopping)
+                return;
+            seenGeneration = workGeneration;
+        }
+
+        rasterizeTiles(*tileBuffers[index]);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busyWorkers == 0) {
+            workDone.notify_one();
+        }
+    }
+}
+
+void SoftwareRenderer::rasterizeTiles(TileBuffer &buffer) {
+    PROFILE_ZONE("SoftwareRenderer::rasterizeTiles");
+    const int tileCount = tilesX * tilesY;
+    for (int tile = nextTile++; tile < tileCount; tile = nextTile++) {
+        rasterizeTile(tile, buffer);
+    }
+}
+
+void SoftwareRenderer::rasterizeTile(int tile, TileBuffer &buffer) {
+    const int tileX = (tile % tilesX) * tileSize, tileY = (tile / tilesX) * tileSize;
+    const int tileWidth = std::min(tileSize, width - tileX), tileHeight = std::min(tileSize, height - tileY);
+
+    std::fill_n(buffer.r, tileSize * tileSize, clearColor.x);
+    std::fill_n(buffer.g, tileSize * tileSize, clearColor.y);
+    std::fill_n(buffer.b, tileSize * tileSize, clearColor.z);
+    std::fill_n(buffer.a, tileSize * tileSize, clearColor.w);
+
+    const Float4 zero(0.0f), one(1.0f), half(0.5f);
+    for (uint32_t entry = binStarts[tile]; entry < binStarts[tile + 1]; ++entry) {
+        const Primitive &p = primitives[binEntries[entry]];
+        // tile-local span; the start is rounded down to a group of four pixels
+        const int x0 = (std::max(p.x0, tileX) - tileX) & ~3, x1 = std::min(p.x1, tileX + tileSize) - tileX;
+        const int y0 = std::max(p.y0, tileY) - tileY, y1 = std::min(p.y1, tileY + tileSize) - tileY;
+
+        switch (p.kind) {
+            case PrimitiveKind::Box: {
+                // the rows are already exact, only the columns of the first and last group need a test
+                const Float4 minX(p.a.x), maxX(p.b.x);
+                blend(buffer.r, buffer.g, buffer.b, buffer.a, tileSize, tileX, tileY, x0, x1, y0, y1, p.color,
+                      [&](Float4 px, float) { return select((px >= minX) & (px < maxX), one, zero); });
+                break;
+            }
+            case PrimitiveKind::RoundedBox: {
+                // the same distance as circle.frag; fwidth of a distance field is |nx| + |ny| of its gradient
+                const Float4 centerX(p.a.x), halfX(p.b.x), radius(p.cornerRadius), epsilon(1e-4f);
+                blend(buffer.r, buffer.g, buffer.b, buffer.a, tileSize, tileX, tileY, x0, x1, y0, y1, p.color,
+                      [&](Float4 px, float py) {
+                          const Float4 qx = abs(px - centerX) - halfX + radius;
+                          const Float4 qy(std::fabs(py - p.a.y) - p.b.y + p.cornerRadius);
+                          const Float4 mx = max(qx, zero), my = max(qy, zero);
+                          const Float4 length = sqrt(mx * mx + my * my);
+                          const Float4 distance = length + min(max(qx, qy), zero) - radius;
+                          const Float4 width = select(length >= epsilon, (mx + my) / max(length, epsilon), one);
+                          return clamp(half - distance / width, zero, one);
+                      });
+                break;
+            }
+            case PrimitiveKind::Triangle: {
+                // inside when on the same side of all three edges, whatever the winding
+                const float area = (p.b.x - p.a.x) * (p.c.y - p.a.y) - (p.b.y - p.a.y) * (p.c.x - p.a.x);
+                const vec2 b = area >= 0 ? p.b : p.c, c = area >= 0 ? p.c : p.b;
+                const vec2 corners[3] = {p.a, b, c};
+                blend(buffer.r, buffer.g, buffer.b, buffer.a, tileSize, tileX, tileY, x0, x1, y0, y1, p.color,
+                      [&](Float4 px, float py) {
+                          Float4 edges[3];
+                          for (int i = 0; i < 3; ++i) {
+                              const vec2 from = corners[i], to = corners[(i + 1) % 3];
+                              edges[i] = Float4(to.x - from.x) * Float4(py - from.y)
+                                       - Float4(to.y - from.y) * (px - Float4(from.x));
+                          }
+                          const Float4 inside = (edges[0] >= zero) & (edges[1] >= zero) & (edges[2] >= zero);
+                          return select(inside, one, zero);
+                      });
+                break;
+            }
+            case PrimitiveKind::Glyph: {
+                const unsigned char *page = fontRenderer.getFont().getAtlasPixels(p.page);
+                const bool sdf = fontRenderer.getMode() == FontMode::SDF;
+                const Float4 minX(p.a.x), maxX(p.b.x);
+                const float du = (p.uv.z - p.uv.x) / (p.b.x - p.a.x), dv = (p.uv.w - p.uv.y) / (p.b.y - p.a.y);
+                const Float4 edge0(0.5f - p.smoothing), edgeScale(p.smoothing > 0 ? 0.5f / p.smoothing : 0.0f);
+                blend(buffer.r, buffer.g, buffer.b, buffer.a, tileSize, tileX, tileY, x0, x1, y0, y1, p.color,
+                      [&](Float4 px, float py) {
+                          const Float4 inside = (px >= minX) & (px < maxX);
+                          if (!any(inside))
+                              return zero;
+                          // the atlas is sampled per pixel; there is no gather in SSE2
+                          alignas(16) float x[4], samples[4];
+                          px.store(x);
+                          const float v = p.uv.y + (py - p.a.y) * dv;
+                          for (int lane = 0; lane < 4; ++lane) {
+                              samples[lane] = sampleAtlas(page, p.uv.x + (x[lane] - p.a.x) * du, v);
+                          }
+                          Float4 value = Float4::load(samples);
+                          if (sdf) {
+                              const Float4 t = clamp((value - edge0) * edgeScale, zero, one);
+                              value = t * t * (Float4(3.0f) - Float4(2.0f) * t);
+                          }
+                          return select(inside, value, zero);
+                      });
+                break;
+            }
+        }
+    }
+
+    // Convert to bytes; the last group of a row may be cut off by the edge of the frame
+    for (int y = 0; y < tileHeight; ++y) {
+        unsigned char *row = framebuffer.data() + (size_t(tileY + y) * width + tileX) * 4;
+        for (int x = 0; x < tileWidth; x += 4) {
+            const int i = y * tileSize + x;
+            alignas(16) unsigned char pixels[16];
+            storeRgba(Float4::load(buffer.r + i), Float4::load(buffer.g + i), Float4::load(buffer.b + i),
+                      Float4::load(buffer.a + i), pixels);
+            std::copy_n(pixels, std::min(4, tileWidth - x) * 4, row + x * 4);
+        }
+    }
+}
+
+void SoftwareRenderer::present() {
+    PROFILE_ZONE("SoftwareRenderer::present");
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, framebuffer.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Blit into whatever is bound for drawing (the window or the headless framebuffer), then restore the
+    // read binding, which captures read from
+    GLint boundReadFramebuffer = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &boundReadFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, boundReadFramebuffer);
+
+    glStats.bufferUploads++;
+    glStats.drawCalls++;
+    glStats.stateChanges += 4;
+}
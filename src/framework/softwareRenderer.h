@@ -0,0 +1,139 @@
+#ifndef GRAPHICS_SOFTWARERENDERER_H
+#define GRAPHICS_SOFTWARERENDERER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "renderer.h"
+#include "../util/simd.h"
+
+/// @brief Renderer backend that rasterizes on the CPU.
+/// @details The sorted commands become a list of primitives (boxes, rounded boxes, triangles and glyph
+/// quads), binned into tiles of tileSize x tileSize pixels. Worker threads rasterize whole tiles, four pixels
+/// at a time (SSE2 where available, plain C++ elsewhere), blending every primitive of the tile in order in a
+/// float scratch buffer that stays in cache. The output only depends on the submitted commands, not on the
+/// driver or the number of threads.
+///
+/// The frame is kept in a CPU framebuffer (see getPixels()), which captures and recordings read. When there is a
+/// window it is also blitted to the bound GL framebuffer at the end of flush(); without one no OpenGL is used at
+/// all. Assumes the projection maps one unit to one pixel with the origin in the bottom left. Sprites and the SDF
+/// outline and glow are not drawn.
+class SoftwareRenderer : public Renderer {
+public:
+    /// @brief Construct a new SoftwareRenderer that presents to the current GL context, and start its worker threads
+    /// @param shaderManager Used to look up the "sprite", "circle" and "particle" programs (for sorting only)
+    /// @param fontRenderer Used to lay out text runs and read the glyph atlas
+    /// @param width The width of the frame in pixels
+    /// @param height The height of the frame in pixels
+    SoftwareRenderer(ShaderManager &shaderManager, FontRenderer &fontRenderer, int width, int height);
+
+    /// @brief Construct a new SoftwareRenderer that only draws into getPixels(), with no GL context at all
+    /// @param fontRenderer Used to lay out text runs and read the glyph atlas
+    /// @param width The width of the frame in pixels
+    /// @param height The height of the frame in pixels
+    SoftwareRenderer(FontRenderer &fontRenderer, int width, int height);
+
+    /// @brief Stops the worker threads and deletes the texture the frame is presented from, if any
+    ~SoftwareRenderer() override;
+
+    SoftwareRenderer(const SoftwareRenderer &) = delete;
+    SoftwareRenderer &operator=(const SoftwareRenderer &) = delete;
+
+    /// @brief Sets the color the next flush() starts from
+    void clear(vec4 color) override;
+
+    /// @brief Reserves room for the primitives and bin entries of count particles
+    void reserveParticles(size_t count) override;
+
+    /// @brief Returns the last frame as RGBA bytes, bottom row first
+    const unsigned char *getPixels() const override;
+
+protected:
+    void execute() override;
+
+private:
+    /// @brief Width and height of a tile in pixels; a multiple of 4
+    static const int tileSize = 64;
+
+    /// @brief Upper bound on worker threads (the calling thread works too)
+    static const int maxWorkers = 7;
+
+    enum class PrimitiveKind : uint8_t { Box, RoundedBox, Triangle, Glyph };
+
+    /// @brief Something to blend into the frame
+    /// @details Box and Glyph cover [a, b); RoundedBox is centered on a with half size b and corner radius;
+    /// Triangle has the corners a, b and c.
+    struct Primitive {
+        PrimitiveKind kind;
+        /// @brief Pixel bounds, clipped to the frame: [x0, x1) x [y0, y1)
+        int x0, y0, x1, y1;
+        vec4 color;
+        vec2 a, b, c;
+        float cornerRadius;
+        /// @brief Glyph texture coordinates: u0 and v at a, u1 and v at b; and the atlas page
+        vec4 uv;
+        unsigned int page;
+        /// @brief Half width of the SDF edge transition, in distance field units
+        float smoothing;
+    };
+
+    /// @brief Float RGBA planes of one tile, owned by one thread
+    struct TileBuffer {
+        alignas(16) float r[tileSize * tileSize];
+        alignas(16) float g[tileSize * tileSize];
+        alignas(16) float b[tileSize * tileSize];
+        alignas(16) float a[tileSize * tileSize];
+    };
+
+    /// @brief Sizes the framebuffer and scratch buffers and starts the worker threads
+    void start();
+
+    /// @brief Appends a primitive if it touches the frame
+    void addPrimitive(Primitive primitive, float minX, float minY, float maxX, float maxY);
+    void addShape(const Shape &shape);
+    void addGlyphs(const GlyphVertex *vertices, size_t count);
+    /// @brief Adds every live particle as a round dot
+    void addParticles(const ParticleSystem &particles);
+
+    /// @brief Rasterizes tiles until none are left; run by every thread during a frame
+    void rasterizeTiles(TileBuffer &buffer);
+    void rasterizeTile(int tile, TileBuffer &buffer);
+    void workerLoop(int index);
+
+    /// @brief Copies the framebuffer to the bound GL framebuffer
+    void present();
+
+    int width, height;
+    int tilesX, tilesY;
+    vec4 clearColor = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+    /// @brief RGBA8 frame, bottom row first like GL
+    vector<unsigned char> framebuffer;
+
+    /// @brief Primitives of the frame in draw order, and per tile the indices of those touching it
+    /// @details The indices of tile t are binEntries[binStarts[t]] up to binEntries[binStarts[t + 1]];
+    /// binCursors is scratch for filling them. Cleared (not freed) every frame.
+    vector<Primitive> primitives;
+    vector<uint32_t> binStarts, binCursors, binEntries;
+    vector<GlyphVertex> glyphScratch;
+
+    /// @brief Scratch tiles: [0] for the calling thread, then one per worker
+    vector<std::unique_ptr<TileBuffer>> tileBuffers;
+    vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable startWork, workDone;
+    /// @brief Incremented to start a frame; workers wait for it to change
+    unsigned int workGeneration = 0;
+    int busyWorkers = 0;
+    bool stopping = false;
+    std::atomic<int> nextTile{0};
+
+    /// @brief Texture the frame is uploaded to, and a framebuffer to blit it from; 0 without a GL context
+    GLuint texture = 0, readFramebuffer = 0;
+
+    bool warnedSprites = false;
+};
+
+#endif //GRAPHICS_SOFTWARERENDERER_H
@@ -0,0 +1,123 @@
+#include "streamBuffer.h"
+
+#include <cstring>
+#include <iostream>
+#include "glStats.h"
+#include "profiler.h"
+
+StreamBuffer::StreamBuffer(GLsizeiptr segmentSize) : segmentSize(segmentSize) {
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+#if defined(GL_VERSION_4_4) || defined(GL_ARB_buffer_storage)
+    if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage) {
+        // Immutable storage, mapped once for the lifetime of the buffer
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, segmentSize * segmentCount, nullptr, flags);
+        mapped = static_cast<char *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, segmentSize * segmentCount, flags));
+    }
+#endif
+
+    if (mapped == nullptr) {
+        // Orphaning fallback: only one segment of storage is needed, the driver renames it every frame
+        glBufferData(GL_ARRAY_BUFFER, segmentSize, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (GLsync &fence : fences) {
+        if (fence != nullptr)
+            glDeleteSync(fence);
+    }
+    if (mapped != nullptr) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &buffer);
+}
+
+void StreamBuffer::beginFrame() {
+    // includes waiting for the GPU to release the segment
+    PROFILE_ZONE("StreamBuffer::beginFrame");
+    head = 0;
+
+    if (mapped == nullptr) {
+        // Give the driver new storage; the old one is freed once the GPU is done with it
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, segmentSize, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glStats.bufferUploads++;
+        glStats.stateChanges += 2;
+        return;
+    }
+
+    segment = (segment + 1) % segmentCount;
+
+    // Wait until the GPU has finished the frame that last used this segment
+    GLsync &fence = fences[segment];
+    if (fence != nullptr) {
+        GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while (result == GL_TIMEOUT_EXPIRED)
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
+void StreamBuffer::endFrame() {
+    if (mapped != nullptr)
+        fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+GLintptr StreamBuffer::upload(const void *data, GLsizeiptr size, GLsizeiptr alignment) {
+    GLintptr offset = allocate(size, alignment);
+    if (offset >= 0)
+        write(offset, data, size);
+    return offset;
+}
+
+GLintptr StreamBuffer::allocate(GLsizeiptr size, GLsizeiptr alignment) {
+    // Align the offset in the whole buffer, not in the segment: callers divide it by their vertex stride,
+    // which does not have to divide the segment size
+    GLintptr base = mapped != nullptr ? segment * segmentSize : 0;
+    GLsizeiptr start = (base + head + alignment - 1) / alignment * alignment - base;
+    if (start + size > segmentSize) {
+        if (!reportedFull) {
+            std::cout << "ERROR::STREAMBUFFER: Segment of " << segmentSize << " bytes is full" << std::endl;
+            reportedFull = true;
+        }
+        return -1;
+    }
+    head = start + size;
+    return base + start;
+}
+
+void StreamBuffer::write(GLintptr offset, const void *data, GLsizeiptr size) {
+    if (mapped != nullptr) {
+        std::memcpy(mapped + offset, data, size);
+        return;
+    }
+
+    // Writing to freshly orphaned storage does not have to wait for the GPU
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glStats.bufferUploads++;
+    glStats.stateChanges += 2;
+}
+
+GLsizeiptr StreamBuffer::available(GLsizeiptr alignment) const {
+    GLintptr base = mapped != nullptr ? segment * segmentSize : 0;
+    GLsizeiptr start = (base + head + alignment - 1) / alignment * alignment - base;
+    return start < segmentSize ? segmentSize - start : 0;
+}
+
+GLuint StreamBuffer::getBuffer() const {
+    return buffer;
+}
+
+bool StreamBuffer::isPersistent() const {
+    return mapped != nullptr;
+}
@@ -0,0 +1,77 @@
+#ifndef GRAPHICS_STREAMBUFFER_H
+#define GRAPHICS_STREAMBUFFER_H
+
+#include <glad/glad.h>
+
+/// @brief Ring buffer for geometry and uniforms that are rewritten every frame.
+/// @details The buffer is split into segmentCount segments, one per frame in flight. With
+/// GL_ARB_buffer_storage (GL 4.4) the whole buffer is persistently and coherently mapped, uploads
+/// are plain memcpys into the current segment, and a fence per segment makes sure the GPU is done
+/// reading it before it is written again. On plain GL 3.3 the buffer is orphaned at the start of
+/// every frame instead, which gives the driver fresh storage without waiting for the GPU.
+class StreamBuffer {
+public:
+    /// @brief Number of frames that may be in flight at once
+    static const int segmentCount = 3;
+
+    /// @brief Creates the buffer (requires a current OpenGL context)
+    /// @param segmentSize Bytes available to each frame
+    explicit StreamBuffer(GLsizeiptr segmentSize);
+
+    /// @brief Unmaps and deletes the buffer and any pending fences
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+    /// @brief Moves to the next segment, waiting for the GPU if it still reads from it
+    /// @details Call once at the start of the frame, before any upload().
+    void beginFrame();
+
+    /// @brief Fences the commands that read this frame's segment
+    /// @details Call once after the last draw of the frame.
+    void endFrame();
+
+    /// @brief Copies data into the current segment
+    /// @param data The data to copy
+    /// @param size Number of bytes to copy
+    /// @param alignment Required alignment of the returned offset (e.g. the vertex stride)
+    /// @return Offset of the data in the buffer, or -1 if the segment is full
+    GLintptr upload(const void *data, GLsizeiptr size, GLsizeiptr alignment);
+
+    /// @brief Reserves a range of the current segment, to be filled with write()
+    /// @details For data written in parts at fixed distances from each other, e.g. one array per attribute.
+    /// @return Offset of the range in the buffer, or -1 if the segment is full
+    GLintptr allocate(GLsizeiptr size, GLsizeiptr alignment);
+
+    /// @brief Copies data into part of a range returned by allocate() this frame
+    void write(GLintptr offset, const void *data, GLsizeiptr size);
+
+    /// @brief Returns how many bytes an allocate() with this alignment could still get from the current segment
+    GLsizeiptr available(GLsizeiptr alignment) const;
+
+    /// @brief Returns the OpenGL buffer name, for attribute pointers and glBindBufferRange
+    GLuint getBuffer() const;
+
+    /// @brief Returns true if the buffer is persistently mapped (GL_ARB_buffer_storage)
+    bool isPersistent() const;
+
+private:
+    GLuint buffer = 0;
+    GLsizeiptr segmentSize;
+
+    /// @brief Segment written this frame and the next free byte inside it
+    int segment = 0;
+    GLsizeiptr head = 0;
+
+    /// @brief Start of the persistent mapping, nullptr when orphaning
+    char *mapped = nullptr;
+
+    /// @brief One fence per segment, placed by endFrame()
+    GLsync fences[segmentCount] = {};
+
+    /// @brief Only report a full segment once
+    bool reportedFull = false;
+};
+
+#endif //GRAPHICS_STREAMBUFFER_H
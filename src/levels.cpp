@@ -0,0 +1,137 @@
+#include "levels.h"
+
+#include <random>
+
+using glm::vec2;
+
+void buildEasyLevel(std::vector<BrickSpec> &bricks) {
+    int x = 950;
+    int y = 725;
+    // Change color for each subsequent line
+    color currColor = color(.7,0,.5,1);
+    for (int i = 0; i < 29; ++i) {
+        if (x > 25) {
+            bricks.push_back({vec2{x, y}, vec2{85, 40}, currColor});
+            x -= 100;
+        }
+        else {
+            // Else block for changing color based off of y position
+            y -= 50;
+            if (y < 725 && y >= 675) {
+                x = 900;
+                // Change color for each subsequent line
+                currColor = color(.5,.9,0,1);
+            }
+            if (y < 675 && y >= 625) {
+                // Change color for each subsequent line
+                currColor = color(0,.5,.7,1);
+                x = 950;
+            }
+            --i;
+        }
+    }
+}
+
+void buildNormalLevel(std::vector<BrickSpec> &bricks) {
+    int x = 950;
+    int y = 725;
+    // Change color for each subsequent line
+    color currColor = color(.7,0,.5,1);
+    for (int i = 0; i < 38; ++i) {
+        if (x > 25) {
+            if (i % 2 == 0) {
+                bricks.push_back({vec2{x, y}, vec2{85, 40}, currColor});
+            }
+            x -= 100;
+        }
+        else {
+            // Else block for changing color based off of y position
+            y -= 50;
+            if (y < 725 && y >= 675) {
+                // Change color for each subsequent line
+                currColor = color(.5,.9,0,1);
+                x = 900;
+            }
+            if (y < 675 && y >= 625) {
+                // Change color for each subsequent line
+                currColor = color(0,.5,.7,1);
+                x = 950;
+            }
+            if (y < 625 && y >= 575) {
+                // Change color for each subsequent line
+                currColor = color(.7,.3,.7,1);
+                x = 900;
+            }
+            --i;
+        }
+    }
+}
+
+void buildHardLevel(std::vector<BrickSpec> &bricks) {
+    int x = 900;
+    int y = 725;
+    color currColor = color(.7,0,.5,1);
+    for (int i = 0; i < 38; ++i) {
+        if (x > 25) {
+            bricks.push_back({vec2{x, y}, vec2{85, 40}, currColor});
+            x -= 100;
+        }
+        else {
+            // Else block for changing color based off of y position
+            y -= 50;
+            if (y < 725 && y >= 675) {
+                // Change color for each subsequent line
+                currColor = color(.5,.9,0,1);
+                x = 950;
+            }
+            if (y < 675 && y >= 625) {
+                // Change color for each subsequent line
+                currColor = color(0,.5,.7,1);
+                x = 900;
+            }
+            if (y < 625 && y >= 575) {
+                // Change color for each subsequent line
+                currColor = color(.7,.3,.7,1);
+                x = 950;
+            }
+            --i;
+        }
+    }
+}
+
+void buildRandomLevel(std::vector<BrickSpec> &bricks, unsigned int seed) {
+    // A generator of its own, so the level only depends on the seed, whatever thread builds it
+    std::minstd_rand random(seed);
+    const size_t first = bricks.size();
+    int x = 950;
+    int y = 725;
+    for (int i = 0; i < 40; ++i) {
+        if (x > 25) {
+            // A one in five chance to add each block to the vector
+            if (random() % 5 == 0) {
+                // Add the brick with a random color
+                bricks.push_back({vec2{x, y}, vec2{85, 40}, color(float(random() % 10 / 10.0), float(random() % 10 / 10.0), float(random() % 10 / 10.0),.95)});
+            }
+            x -= 100;
+        }
+        else {
+            // Decrement y position and reset x to the left
+            y -= 50;
+            x = 950;
+            --i;
+        }
+    }
+    // If no bricks at all get added, add one brick
+    if (bricks.size() == first) {
+        bricks.push_back({vec2{500, 750}, vec2{85, 40}, color(float(random() % 10 / 10.0), float(random() % 10 / 10.0), float(random() % 10 / 10.0),.95)});
+    }
+}
+
+LevelSpecs buildLevels(unsigned int seed) {
+    LevelSpecs levels;
+    buildEasyLevel(levels[0]);
+    buildNormalLevel(levels[1]);
+    buildHardLevel(levels[2]);
+    buildRandomLevel(levels[3], seed);
+    return levels;
+}
@@ -0,0 +1,41 @@
+#ifndef GRAPHICS_LEVELS_H
+#define GRAPHICS_LEVELS_H
+
+#include <array>
+#include <vector>
+
+#include "framework/color.h"
+#include "glm/glm.hpp"
+
+/// @brief Where a brick goes, how big it is and its color
+struct BrickSpec {
+    glm::vec2 pos;
+    glm::vec2 size;
+    color fill;
+};
+
+// The brick layout of every difficulty. These only compute positions and colors, so they need no GL
+// context; Engine::initShapes() turns the specs into Rects.
+
+/// @brief Appends the bricks of the easy level: three full rows
+void buildEasyLevel(std::vector<BrickSpec> &bricks);
+
+/// @brief Appends the bricks of the normal level: four rows with every other brick left out
+void buildNormalLevel(std::vector<BrickSpec> &bricks);
+
+/// @brief Appends the bricks of the hard level: four offset rows
+void buildHardLevel(std::vector<BrickSpec> &bricks);
+
+/// @brief Appends the bricks of the random level: each brick of four rows with a one in five chance and a
+/// random color, and at least one brick
+/// @param seed Seeds the generator the bricks are drawn from; the same seed gives the same level
+void buildRandomLevel(std::vector<BrickSpec> &bricks, unsigned int seed);
+
+/// @brief The bricks of every difficulty: easy, normal, hard and random
+using LevelSpecs = std::array<std::vector<BrickSpec>, 4>;
+
+/// @brief Builds the bricks of every difficulty
+/// @param seed Seed of the random level, see buildRandomLevel()
+LevelSpecs buildLevels(unsigned int seed);
+
+#endif //GRAPHICS_LEVELS_H
@@ -1,18 +1,93 @@
 
 #include "engine.h"
+#include "framework/allocationTracker.h"
+#include "framework/frameTimeReport.h"
+#include "framework/profiler.h"
 
+#include <chrono>
 #include <iostream>
+#include <memory>
+
+namespace {
+    /// @brief Frames left out of the benchmark statistics: shader compilation, first uploads, glyph loading
+    const int benchmarkWarmupFrames = 60;
+
+    float millisecondsSince(std::chrono::steady_clock::time_point &last) {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        float milliseconds = std::chrono::duration<float, std::milli>(now - last).count();
+        last = now;
+        return milliseconds;
+    }
+}
 
 
 int main(int argc, char *argv[]) {
-    Engine engine;
+    const std::chrono::steady_clock::time_point launch = std::chrono::steady_clock::now();
+    EngineConfig config = EngineConfig::parse(argc, argv);
+    if (!config.valid) {
+        return 1;
+    }
+    if (config.allocationGate >= 0 && !AllocationTracker::enabled) {
+        std::cout << "ERROR::CONFIG: --alloc-gate needs a build with the TRACK_ALLOCATIONS option" << std::endl;
+        return 1;
+    }
 
-    while (!engine.shouldClose()) {
-        engine.processInput();
-        engine.update();
-        engine.render();
+    Profiler::setThreadName("main");
+    int allocationGateFailures = 0;
+    bool benchmarkWritten = true;
+    {
+        // Scoped so the engine releases its GL objects before the context is destroyed
+        Engine engine(config);
+        std::unique_ptr<FrameTimeReport> report;
+        if (!config.benchmarkReport.empty()) {
+            report = std::make_unique<FrameTimeReport>(config.frames, benchmarkWarmupFrames);
+        }
+
+        // Measurement runs also report how long startup took
+        bool reportStartup = report || !config.traceFile.empty();
+        while (!engine.shouldClose()) {
+            {
+                PROFILE_ZONE("Frame");
+                std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+                engine.processInput();
+                float input = millisecondsSince(last);
+                engine.update();
+                float update = millisecondsSince(last);
+                engine.render();
+                float render = millisecondsSince(last);
+                if (report) {
+                    report->addFrame(input, update, render);
+                }
+            }
+            // Everything startup does, up to the first frame handed to the window (or framebuffer)
+            if (reportStartup) {
+                std::chrono::duration<float, std::milli> startup = std::chrono::steady_clock::now() - launch;
+                std::cout << "Startup: first frame after " << startup.count() << " ms" << std::endl;
+                reportStartup = false;
+            }
+            Profiler::endFrame();
+        }
+
+        if (report) {
+            report->print();
+            benchmarkWritten = report->writeJson(config.benchmarkReport, config.software ? "software" : "gl",
+                                                 EngineConfig::benchmarkSeed);
+        }
+
+        if (!config.traceFile.empty()) {
+            Profiler::printStats();
+            Profiler::writeTrace(config.traceFile);
+        }
+        allocationGateFailures = engine.getAllocationGateFailures();
     }
 
-    glfwTerminate();
-    return 0;
+    // The headless context is destroyed with the engine; GLFW was never started
+    if (!config.headless) {
+        glfwTerminate();
+    }
+    if (allocationGateFailures > 0) {
+        std::cout << "Allocation gate: " << allocationGateFailures << " frames allocated after warm-up" << std::endl;
+        return 1;
+    }
+    return benchmarkWritten ? 0 : 1;
 }
@@ -0,0 +1,62 @@
+#include "scriptedSession.h"
+
+#include <algorithm>
+#include <GLFW/glfw3.h>
+
+namespace {
+    /// @brief Frames to wait on the menu and on the end screens before pressing a key, like a player would
+    const int pauseFrames = 30;
+
+    /// @brief Menu keys of the difficulties, in the order they are played
+    const int difficultyKeys[] = {GLFW_KEY_E, GLFW_KEY_N, GLFW_KEY_H, GLFW_KEY_R};
+
+    /// @brief Presses left or right to move the paddle towards x
+    void steer(float paddleX, float x, bool keys[1024]) {
+        const float tolerance = 5.0f;
+        keys[GLFW_KEY_LEFT] = paddleX > x + tolerance;
+        keys[GLFW_KEY_RIGHT] = paddleX < x - tolerance;
+    }
+}
+
+ScriptedSession::ScriptedSession(int playFrames) : playFrames(playFrames) {}
+
+void ScriptedSession::press(const SessionView &view, bool keys[1024]) {
+    std::fill(keys, keys + 1024, false);
+    phaseFrames++;
+
+    // Move on once the game has reacted to the last key
+    Phase next = phase;
+    if (phase == Phase::Menu && view.screen == SessionView::Screen::Playing) {
+        next = Phase::Play;
+    } else if ((phase == Phase::Play || phase == Phase::Drop) && view.screen == SessionView::Screen::GameOver) {
+        next = Phase::GameOver;
+    } else if (phase == Phase::Play && phaseFrames > playFrames) {
+        next = Phase::Drop;
+    } else if (phase == Phase::GameOver && view.screen == SessionView::Screen::Menu) {
+        next = Phase::Menu;
+        difficulty = (difficulty + 1) % 4;
+    }
+    if (next != phase) {
+        phase = next;
+        phaseFrames = 0;
+    }
+
+    const bool ballResting = view.ballVelocity == glm::vec2(0.0f, 0.0f);
+    switch (phase) {
+        case Phase::Menu:
+            keys[difficultyKeys[difficulty]] = phaseFrames >= pauseFrames;
+            break;
+        case Phase::Play:
+            keys[GLFW_KEY_SPACE] = ballResting;
+            steer(view.paddleX, view.ballPos.x, keys);
+            break;
+        case Phase::Drop:
+            // keep launching, but with the paddle well away from the ball so it is lost
+            keys[GLFW_KEY_SPACE] = ballResting;
+            steer(view.paddleX, view.ballPos.x < view.screenWidth / 2 ? view.screenWidth : 0.0f, keys);
+            break;
+        case Phase::GameOver:
+            keys[GLFW_KEY_P] = phaseFrames >= pauseFrames;
+            break;
+    }
+}
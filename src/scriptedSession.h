@@ -0,0 +1,40 @@
+#ifndef GRAPHICS_SCRIPTEDSESSION_H
+#define GRAPHICS_SCRIPTEDSESSION_H
+
+#include "glm/glm.hpp"
+
+/// @brief What the ScriptedSession needs to know about the game each frame
+struct SessionView {
+    enum class Screen { Menu, Playing, GameOver };
+    Screen screen;
+    glm::vec2 ballPos, ballVelocity;
+    float paddleX;
+    float screenWidth;
+};
+
+/// @brief Plays the game through every difficulty without a player, for benchmarking
+/// @details Cycles through easy, normal, hard and random: picks the difficulty from the menu, launches the
+/// ball and steers the paddle under it for playFrames frames, then stops steering until the game is lost
+/// (or won), and presses p to return to the menu. Decisions only depend on the game state, so the session
+/// follows the game whatever the frame rate or the random bounces.
+class ScriptedSession {
+public:
+    /// @param playFrames Frames to keep the ball in play before letting it drop
+    explicit ScriptedSession(int playFrames = 300);
+
+    /// @brief Sets the keys for the next frame
+    /// @param keys Indexed with GLFW_KEY_*, as Engine::keys
+    void press(const SessionView &view, bool keys[1024]);
+
+private:
+    enum class Phase { Menu, Play, Drop, GameOver };
+
+    Phase phase = Phase::Menu;
+    /// @brief Frames spent in the current phase
+    int phaseFrames = 0;
+    int playFrames;
+    /// @brief Index of the difficulty being played, into the menu keys
+    int difficulty = 0;
+};
+
+#endif //GRAPHICS_SCRIPTEDSESSION_H
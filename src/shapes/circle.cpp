@@ -2,32 +2,18 @@
 #include "rect.h"
 
 
-Circle::~Circle() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
+mat4 Circle::getModelMatrix() const {
+    // The shared mesh is a unit circle, so scale it by the radius as well as the size
+    mat4 model = mat4(1.0f);
+    model = translate(model, vec3(pos, 1.0f));
+    model = scale(model, vec3(size * radius, 1.0f));
+    return model;
 }
 
 void Circle::setUniforms() const {
     Shape::setUniforms(); // Sets model and shapeColor uniforms
-    shader.setFloat("radius", radius);
-    shader.setVector2f("center", pos.x, pos.y);
-}
-
-void Circle::draw() const {
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, segments + 2); // +2 for center and last vertex
-    glBindVertexArray(0);
-}
-
-void Circle::initVectors() {
-    // Center of circle
-    vertices.push_back(0.0f);
-    vertices.push_back(0.0f);
-    for (int i = 0; i <= segments; ++i) {
-        float theta = 2.0f * 3.1415926f * float(i) / float(segments);
-        vertices.push_back(radius * cosf(theta)); // x = r*cos(theta)
-        vertices.push_back(radius * sinf(theta)); // y = r*sin(theta)
-    }
+    shader.set(radiusUniform, radius);
+    shader.set(centerUniform, pos);
 }
 
 void Circle::setRadius(float radius) {
@@ -37,6 +23,8 @@ void Circle::setRadius(float radius) {
 
 float Circle::getRadius() const { return radius; }
 
+float Circle::getDrawRadius() const { return size.x * radius; }
+
 float Circle::getLeft() const   { return pos.x - radius; }
 float Circle::getRight() const  { return pos.x + radius; }
 float Circle::getTop() const    { return pos.y + radius; }
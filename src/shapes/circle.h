@@ -9,25 +9,22 @@ using std::vector, glm::vec2, glm::vec3, glm::normalize, glm::dot;
 
 class Circle : public Shape {
 private:
-
-    /// @brief Number of x,y points to draw the circle
-    const static int segments = 100;
-
     /// @brief Radius of the circle (half of screen width
     float radius;
     /// @brief The x and y velocities of the circle
     vec2 velocity;
 
+    /// @brief Uniform handles for the circle-specific uniforms
+    Uniform<float> radiusUniform;
+    Uniform<vec2> centerUniform;
+
 public:
     /// @brief Construct a new Circle object
     /// @details This is the main constructor for the Circle class.
     /// @details All other constructors call this constructor.
     Circle(Shader &shader, vec2 pos, vec2 size, vec2 velocity, vec4 color)
-        : Shape(shader, pos, size, color), radius(size.x / 2.0f), velocity(velocity) {
-        initVectors();
-        initVAO();
-        initVBO();
-    }
+        : Shape(shader, pos, size, color, MeshType::Circle), radius(size.x / 2.0f), velocity(velocity),
+          radiusUniform(shader.getUniform<float>("radius")), centerUniform(shader.getUniform<vec2>("center")) {}
 
     Circle(Shader & shader, vec2 pos, vec2 size, struct color color)
         : Circle(shader, pos, size, vec2(0, 0), vec4(color.red, color.green, color.blue, 1.0f)) {}
@@ -39,22 +36,20 @@ public:
     Circle(Shader &shader, vec2 pos, float radius, vec2 velocity, vec4 color)
         : Circle(shader, pos, vec2(radius * 2, radius * 2), velocity, color) {}
 
-    // override setUniforms to set the radius uniform
-    void setUniforms() const override;
-
-    /// @brief Destroy the Circle object
-    /// @details destroys the VAO and VBO associated with the circle
-    ~Circle() override;
-
-    /// @brief Draws the circle
-    void draw() const override;
+    /// @brief Returns the model matrix of the circle
+    /// @details The shared unit circle mesh is scaled by both the radius and the size of the circle.
+    mat4 getModelMatrix() const override;
 
-    /// @brief Computes the border of the circle, and stores the vertices in the circleVertices array.
-    void initVectors();
+    /// @brief Sets the model, color, radius and center uniforms
+    void setUniforms() const override;
 
     /// @brief Returns the radius of the circle
     float getRadius() const;
 
+    /// @brief Returns the radius the circle is drawn with
+    /// @details The unit circle is scaled by both the radius and the size, see getModelMatrix().
+    float getDrawRadius() const;
+
     /// @brief Sets the radius of the circle
     void setRadius(float radius);
 
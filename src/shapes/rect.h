@@ -9,12 +9,9 @@ using glm::vec2, glm::vec3;
 
 
 class Rect : public Shape {
-private:
-    /// @brief Initializes the vertices and indices of the square
-    void initVectors();
 public:
     /// @brief Construct a new Square object
-    /// @details This constructor will call the InitRenderData function.
+    /// @details Rects share the unit quad mesh from the MeshManager.
     /// @param shader The shader to use
     /// @param pos The position of the square
     /// @param size The size of the square
@@ -29,12 +26,6 @@ public:
 
     Rect(Rect const& other);
 
-    /// @brief Destroy the Square object and delete it's VAO and VBO
-    ~Rect();
-
-    /// @brief Binds the VAO and calls the virtual draw function
-    void draw() const override;
-
     float getLeft() const override;
     float getRight() const override;
     float getTop() const override;
@@ -1,57 +1,39 @@
 #include "shape.h"
 
-Shape::Shape(Shader &shader, glm::vec2 pos, glm::vec2 size, struct color color) :
-    shader(shader), pos(pos), size(size), color(color) {}
+Shape::Shape(Shader &shader, glm::vec2 pos, glm::vec2 size, struct color color, MeshType meshType) :
+    shader(shader), pos(pos), size(size), color(color), meshType(meshType),
+    modelUniform(shader.getUniform<mat4>("model")), colorUniform(shader.getUniform<vec4>("shapeColor")) {}
 
 Shape::Shape(Shape const& other) :
-    shader(other.shader), pos(other.pos), size(other.size), color(other.color) {}
+    shader(other.shader), pos(other.pos), size(other.size), color(other.color), meshType(other.meshType),
+    modelUniform(other.modelUniform), colorUniform(other.colorUniform) {}
 
-Shape::Shape(Shader &shader, glm::vec2 pos, vec2 size, vec4 color) :
-    shader(shader), pos(pos), size(size), color(color) {}
+Shape::Shape(Shader &shader, glm::vec2 pos, vec2 size, vec4 color, MeshType meshType) :
+    shader(shader), pos(pos), size(size), color(color), meshType(meshType),
+    modelUniform(shader.getUniform<mat4>("model")), colorUniform(shader.getUniform<vec4>("shapeColor")) {}
 
 
-// Initialize VAO
-unsigned int Shape::initVAO() {
-    glGenVertexArrays(1, &VAO); // Generate VAO
-    glBindVertexArray(VAO); // Bind VAO
-    return VAO;
-}
-
-// Initialize VBO
-void Shape::initVBO() {
-    // Generate VBO, bind it to VAO, and copy vertices data into it
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    // Set the vertex attribute pointers (2 floats per vertex (x, y))
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0); // Enable the vertex attribute at location 0
-    glBindBuffer(GL_ARRAY_BUFFER, 0); // Unbind VBO
-}
-
-// Initialize EBO
-void Shape::initEBO() {
-    glGenBuffers(1, &EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(float), indices.data(), GL_STATIC_DRAW);
-    // Don't unbind EBO because it's bound to VAO
-}
-
-void Shape::setUniforms() const {
-    // If you want to use a custom shader, you have to set it and call it's Use() function here.
-    // Since we are using the same shader for all shapes, we can just set it once in the constructor.
-
+mat4 Shape::getModelMatrix() const {
     // Define the model matrix for the shape as a 4x4 identity matrix
     mat4 model = mat4(1.0f);
     // The model matrix is used to transform the vertices of the shape in relation to the world space.
     model = translate(model, vec3(pos, 1.0f));
     // The size of the shape is scaled by the model matrix to make the shape larger or smaller.
     model = scale(model, vec3(size, 1.0f));
+    return model;
+}
+
+void Shape::setUniforms() const {
+    // If you want to use a custom shader, you have to set it and call it's Use() function here.
+    // Since we are using the same shader for all shapes, we can just set it once in the constructor.
 
     // Set the model matrix and color uniform variables in the shader
-    this->shader.setMatrix4("model", model);
-    this->shader.setVector4f("shapeColor", color.vec);
+    this->shader.set(modelUniform, getModelMatrix());
+    this->shader.set(colorUniform, color.vec);
+}
+
+void Shape::draw() const {
+    MeshManager::getMesh(meshType).draw();
 }
 
 // Setters
@@ -83,6 +65,8 @@ vec2 Shape::getPos() const      { return pos; }
 float Shape::getPosX() const    { return pos.x; }
 float Shape::getPosY() const    { return pos.y; }
 vec2 Shape::getSize() const     { return size; }
+Shader &Shape::getShader() const { return shader; }
+MeshType Shape::getMeshType() const { return meshType; }
 vec2 Shape::getVelocity() const { return velocity; }
 void Shape::setVelocity(vec2 v) { this->velocity = v;}
 
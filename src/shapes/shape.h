@@ -5,6 +5,7 @@
 #include <vector>
 #include "../framework/shader.h"
 #include "../framework/color.h"
+#include "../framework/meshManager.h"
 
 using std::vector, glm::vec2, glm::vec3, glm::vec4, glm::mat4, glm::translate, glm::scale;
 
@@ -15,9 +16,10 @@ class Shape {
         /// @param pos The position of the shape
         /// @param size The size of the shape
         /// @param color The color of the shape
-        Shape(Shader& shader, vec2 pos, vec2 size, color color);
+        /// @param meshType The shared primitive mesh used to draw the shape
+        Shape(Shader& shader, vec2 pos, vec2 size, color color, MeshType meshType);
 
-        Shape(Shader& shader, vec2 pos, vec2 size, vec4 color);
+        Shape(Shader& shader, vec2 pos, vec2 size, vec4 color, MeshType meshType);
 
         /// @brief Copy constructor for Shape
         Shape(Shape const& other);
@@ -25,23 +27,6 @@ class Shape {
         /// @brief Destroy the Shape object
         virtual ~Shape() = default;
 
-        // --------------------------------------------------------
-        // Initialization functions
-        // --------------------------------------------------------
-
-        /// @brief Initializes the VAO.
-        /// @details This function is called in the derived classes' constructor.
-        unsigned int initVAO();
-
-        /// @brief Initializes the VBO.
-        /// @details This function is called in the derived classes' constructor.
-        void initVBO();
-
-        /// @brief Initializes the EBO.
-        /// @details This function is called in the derived classes' constructor.
-        /// @details If function has no indices, pass nullptr for indices and 0 for indexCount.
-        void initEBO();
-
         // --------------------------------------------------------
         // Getters
         // --------------------------------------------------------
@@ -65,6 +50,10 @@ class Shape {
         // Size Functions
         vec2 getSize() const;
 
+        // Rendering Functions
+        Shader &getShader() const;
+        MeshType getMeshType() const;
+
         // Velocity Functions
         vec2 getVelocity() const;
         void setVelocity(vec2 velocity);
@@ -114,11 +103,14 @@ class Shape {
         // Drawing functions
         // --------------------------------------------------------
 
+        /// @brief Returns the model matrix (translation and scale) of the shape
+        virtual mat4 getModelMatrix() const;
+
         /// @brief Sets the uniform variables from members, and calls the virtual draw function
         virtual void setUniforms() const;
 
-        /// @brief Pure virtual function to draw the shape.
-        virtual void draw() const = 0;
+        /// @brief Draws the shared mesh of the shape.
+        virtual void draw() const;
 
 protected:
         /// @brief Shader used to draw all abstract shapes.
@@ -135,14 +127,12 @@ protected:
         /// @brief The VAO of the shape
         struct color color;
 
-        /// @brief The Vertex Array Object, Vertex Buffer Object, and Element Buffer Object of the shape.
-        unsigned int VAO, VBO, EBO;
-
-        /// @brief The vertices of the shape
-        vector<float> vertices;
+        /// @brief The primitive mesh shared with every other shape of the same type
+        MeshType meshType;
 
-        /// @brief The indices of the shape
-        vector<unsigned int> indices;
+        /// @brief Uniform handles resolved from the shader when the shape is constructed
+        Uniform<mat4> modelUniform;
+        Uniform<vec4> colorUniform;
 };
 
 #endif //GRAPHICS_SHAPE_H
@@ -0,0 +1,23 @@
+#include "cacheDirectory.h"
+
+#include <cstdlib>
+
+namespace {
+    std::string resolveCacheDirectory() {
+#ifdef _WIN32
+        if (const char *localAppData = std::getenv("LOCALAPPDATA"); localAppData && *localAppData)
+            return std::string(localAppData) + "/breakout";
+#else
+        if (const char *xdgCache = std::getenv("XDG_CACHE_HOME"); xdgCache && *xdgCache)
+            return std::string(xdgCache) + "/breakout";
+        if (const char *home = std::getenv("HOME"); home && *home)
+            return std::string(home) + "/.cache/breakout";
+#endif
+        return "cache";
+    }
+}
+
+const std::string &cacheDirectory() {
+    static const std::string directory = resolveCacheDirectory();
+    return directory;
+}
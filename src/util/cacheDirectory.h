@@ -0,0 +1,13 @@
+#ifndef GRAPHICS_CACHEDIRECTORY_H
+#define GRAPHICS_CACHEDIRECTORY_H
+
+#include <string>
+
+/// @brief Returns the directory the on-disk caches (font atlases, program binaries) are stored in
+/// @details A per-user directory, so the caches are shared by every launch directory and work when the game is
+/// started from a read-only one: %LOCALAPPDATA%\breakout on Windows, $XDG_CACHE_HOME/breakout or
+/// ~/.cache/breakout elsewhere. Falls back to "cache" in the working directory when none of these is set.
+/// Resolved once; the directory itself is created by whoever writes to it first.
+const std::string &cacheDirectory();
+
+#endif //GRAPHICS_CACHEDIRECTORY_H
@@ -0,0 +1,78 @@
+#ifndef GRAPHICS_FIXEDSTRING_H
+#define GRAPHICS_FIXEDSTRING_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+/// @brief A string in a fixed-size buffer, for formatting text every frame without touching the heap
+/// @details Appending past Capacity characters truncates, and truncated() reports it. Converts to
+/// std::string_view, so it can be passed straight to the text APIs.
+template<size_t Capacity>
+class FixedString {
+public:
+    FixedString() { buffer[0] = '\0'; }
+
+    FixedString &append(std::string_view text) {
+        size_t count = text.size() < Capacity - length ? text.size() : Capacity - length;
+        std::memcpy(buffer + length, text.data(), count);
+        overflowed |= count < text.size();
+        length += count;
+        buffer[length] = '\0';
+        return *this;
+    }
+
+    FixedString &append(char c) {
+        return append(std::string_view(&c, 1));
+    }
+
+    FixedString &append(const char *text) {
+        return append(std::string_view(text));
+    }
+
+    /// @brief Appends an integer in decimal
+    template<typename Integer, typename = std::enable_if_t<std::is_integral_v<Integer>>>
+    FixedString &append(Integer value) {
+        char digits[24];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+        return append(std::string_view(digits, result.ptr - digits));
+    }
+
+    /// @brief Floating point numbers need a number of decimals; without these they would convert to char
+    FixedString &append(float value) = delete;
+    FixedString &append(double value) = delete;
+
+    /// @brief Appends a number with a fixed number of decimals
+    FixedString &append(double value, int decimals) {
+        char digits[48];
+        int count = std::snprintf(digits, sizeof(digits), "%.*f", decimals, value);
+        if (count < 0)
+            return *this;
+        return append(std::string_view(digits, static_cast<size_t>(count) < sizeof(digits) ? count : sizeof(digits) - 1));
+    }
+
+    /// @brief Empties the string for reuse
+    void clear() {
+        length = 0;
+        overflowed = false;
+        buffer[0] = '\0';
+    }
+
+    /// @brief True if something was cut off since the last clear()
+    bool truncated() const { return overflowed; }
+
+    size_t size() const { return length; }
+    const char *c_str() const { return buffer; }
+    std::string_view view() const { return std::string_view(buffer, length); }
+    operator std::string_view() const { return view(); }
+
+private:
+    char buffer[Capacity + 1];
+    size_t length = 0;
+    bool overflowed = false;
+};
+
+#endif //GRAPHICS_FIXEDSTRING_H
@@ -0,0 +1,24 @@
+#ifndef GRAPHICS_HASH_H
+#define GRAPHICS_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 64-bit FNV-1a. Not cryptographic, but fast and stable across runs and platforms,
+// which is all the on-disk caches need from a key.
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+const uint64_t FNV_PRIME = 1099511628211ull;
+
+/// @brief Hashes a block of bytes
+/// @param seed Pass a previous hash to combine several blocks into one key
+inline uint64_t fnv1a(const void *data, size_t size, uint64_t seed = FNV_OFFSET_BASIS) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+#endif //GRAPHICS_HASH_H
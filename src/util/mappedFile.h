@@ -0,0 +1,40 @@
+#ifndef GRAPHICS_MAPPEDFILE_H
+#define GRAPHICS_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/// @brief A read-only, memory-mapped file
+/// @details The contents are paged in by the OS on first access instead of being read up front.
+/// Uses mmap on POSIX systems and a file mapping on Windows.
+class MappedFile {
+public:
+    MappedFile() = default;
+    /// @brief Unmaps the file
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /// @brief Maps a file, unmapping any file mapped before
+    /// @return false if the file does not exist or could not be mapped
+    bool open(const std::string &path);
+
+    /// @brief Unmaps the file
+    void close();
+
+    /// @brief The first byte of the file, or nullptr if nothing is mapped
+    const unsigned char *data() const { return bytes; }
+
+    /// @brief The size of the file in bytes
+    size_t size() const { return length; }
+
+private:
+    const unsigned char *bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void *mapping = nullptr;
+#endif
+};
+
+#endif //GRAPHICS_MAPPEDFILE_H
@@ -0,0 +1,136 @@
+#ifndef GRAPHICS_SIMD_H
+#define GRAPHICS_SIMD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// SSE2 is part of every x86-64 target; anything else gets the plain C++ fallback below,
+// which compilers usually auto-vectorize anyway.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/// @brief Four floats processed together, e.g. four neighbouring pixels
+/// @details Comparisons return lane masks (all bits set or clear) that are combined with & and
+/// consumed by select().
+struct Float4 {
+#ifdef SIMD_SSE2
+    __m128 v;
+
+    Float4() : v(_mm_setzero_ps()) {}
+    Float4(__m128 v) : v(v) {}
+    Float4(float x) : v(_mm_set1_ps(x)) {}
+    Float4(float a, float b, float c, float d) : v(_mm_setr_ps(a, b, c, d)) {}
+
+    static Float4 load(const float *p) { return _mm_loadu_ps(p); }
+    void store(float *p) const { _mm_storeu_ps(p, v); }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.v, b.v); }
+    friend Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.v, b.v); }
+    friend Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.v, b.v); }
+    friend Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a.v, b.v); }
+    friend Float4 operator&(Float4 a, Float4 b) { return _mm_and_ps(a.v, b.v); }
+    friend Float4 operator<(Float4 a, Float4 b) { return _mm_cmplt_ps(a.v, b.v); }
+    friend Float4 operator>=(Float4 a, Float4 b) { return _mm_cmpge_ps(a.v, b.v); }
+
+    friend Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a.v, b.v); }
+    friend Float4 max(Float4 a, Float4 b) { return _mm_max_ps(a.v, b.v); }
+    friend Float4 sqrt(Float4 a) { return _mm_sqrt_ps(a.v); }
+    friend Float4 abs(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+    friend Float4 floor(Float4 a) {
+        // truncation rounds negative values up, so step those down by one
+        __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a.v), _mm_set1_ps(1.0f)));
+    }
+    /// @brief Picks a where the mask is set and b elsewhere
+    friend Float4 select(Float4 mask, Float4 a, Float4 b) {
+        return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+    }
+    /// @brief True if any lane of the mask is set
+    friend bool any(Float4 mask) { return _mm_movemask_ps(mask.v) != 0; }
+#else
+    float v[4];
+
+    Float4() : v{0, 0, 0, 0} {}
+    Float4(float x) : v{x, x, x, x} {}
+    Float4(float a, float b, float c, float d) : v{a, b, c, d} {}
+
+    static Float4 load(const float *p) { return Float4(p[0], p[1], p[2], p[3]); }
+    void store(float *p) const { std::memcpy(p, v, sizeof(v)); }
+
+    template<typename Op>
+    static Float4 map(Float4 a, Float4 b, Op op) {
+        return Float4(op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3]));
+    }
+    static float mask(bool set) {
+        uint32_t bits = set ? 0xFFFFFFFFu : 0u;
+        float m;
+        std::memcpy(&m, &bits, sizeof(m));
+        return m;
+    }
+    static uint32_t bits(float x) {
+        uint32_t b;
+        std::memcpy(&b, &x, sizeof(b));
+        return b;
+    }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x + y; }); }
+    friend Float4 operator-(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x - y; }); }
+    friend Float4 operator*(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x * y; }); }
+    friend Float4 operator/(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x / y; }); }
+    friend Float4 operator&(Float4 a, Float4 b) {
+        return map(a, b, [](float x, float y) {
+            uint32_t r = bits(x) & bits(y);
+            float f;
+            std::memcpy(&f, &r, sizeof(f));
+            return f;
+        });
+    }
+    friend Float4 operator<(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return mask(x < y); }); }
+    friend Float4 operator>=(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return mask(x >= y); }); }
+
+    friend Float4 min(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return y < x ? y : x; }); }
+    friend Float4 max(Float4 a, Float4 b) { return map(a, b, [](float x, float y) { return x < y ? y : x; }); }
+    friend Float4 sqrt(Float4 a) { return map(a, a, [](float x, float) { return std::sqrt(x); }); }
+    friend Float4 abs(Float4 a) { return map(a, a, [](float x, float) { return std::fabs(x); }); }
+    friend Float4 floor(Float4 a) { return map(a, a, [](float x, float) { return std::floor(x); }); }
+    friend Float4 select(Float4 mask, Float4 a, Float4 b) {
+        return Float4(bits(mask.v[0]) ? a.v[0] : b.v[0], bits(mask.v[1]) ? a.v[1] : b.v[1],
+                      bits(mask.v[2]) ? a.v[2] : b.v[2], bits(mask.v[3]) ? a.v[3] : b.v[3]);
+    }
+    friend bool any(Float4 mask) {
+        return bits(mask.v[0]) | bits(mask.v[1]) | bits(mask.v[2]) | bits(mask.v[3]);
+    }
+#endif
+
+    friend Float4 clamp(Float4 a, Float4 lo, Float4 hi) { return min(max(a, lo), hi); }
+};
+
+/// @brief Converts four pixels from channel planes in [0, 1] to interleaved RGBA bytes
+/// @param out Receives 16 bytes
+inline void storeRgba(Float4 r, Float4 g, Float4 b, Float4 a, unsigned char *out) {
+    const Float4 scale(255.0f), half(0.5f), zero(0.0f), one(1.0f);
+#ifdef SIMD_SSE2
+    __m128i ri = _mm_cvttps_epi32((clamp(r, zero, one) * scale + half).v);
+    __m128i gi = _mm_cvttps_epi32((clamp(g, zero, one) * scale + half).v);
+    __m128i bi = _mm_cvttps_epi32((clamp(b, zero, one) * scale + half).v);
+    __m128i ai = _mm_cvttps_epi32((clamp(a, zero, one) * scale + half).v);
+    // r0 r1 r2 r3 g0 .. g3 b0 .. b3 a0 .. a3, then two byte interleaves transpose it to r0 g0 b0 a0 r1 ..
+    __m128i planar = _mm_packus_epi16(_mm_packs_epi32(ri, gi), _mm_packs_epi32(bi, ai));
+    __m128i rbga = _mm_unpacklo_epi8(planar, _mm_srli_si128(planar, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi8(rbga, _mm_srli_si128(rbga, 8)));
+#else
+    const Float4 *channels[4] = {&r, &g, &b, &a};
+    for (int lane = 0; lane < 4; ++lane) {
+        for (int channel = 0; channel < 4; ++channel) {
+            float value = clamp(*channels[channel], zero, one).v[lane] * 255.0f + 0.5f;
+            out[lane * 4 + channel] = static_cast<unsigned char>(value);
+        }
+    }
+#endif
+}
+
+#endif //GRAPHICS_SIMD_H
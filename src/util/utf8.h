@@ -0,0 +1,57 @@
+#ifndef GRAPHICS_UTF8_H
+#define GRAPHICS_UTF8_H
+
+#include <cstdint>
+
+/// @brief Replacement character returned for malformed input
+const uint32_t UTF8_REPLACEMENT = 0xFFFD;
+
+/// @brief Decodes the UTF-8 sequence at it and advances it past it
+/// @details Truncated, overlong or otherwise malformed sequences decode to U+FFFD and skip one byte,
+/// so decoding always makes progress.
+/// @param it The first byte of the sequence, advanced to the next sequence
+/// @param end One past the last byte of the string
+/// @return The codepoint
+inline uint32_t nextCodepoint(const char *&it, const char *end) {
+    const unsigned char first = static_cast<unsigned char>(*it);
+    if (first < 0x80) {
+        ++it;
+        return first;
+    }
+
+    int length;
+    uint32_t codepoint, minimum;
+    if ((first & 0xE0) == 0xC0) {
+        length = 2; codepoint = first & 0x1F; minimum = 0x80;
+    } else if ((first & 0xF0) == 0xE0) {
+        length = 3; codepoint = first & 0x0F; minimum = 0x800;
+    } else if ((first & 0xF8) == 0xF0) {
+        length = 4; codepoint = first & 0x07; minimum = 0x10000;
+    } else {
+        ++it;
+        return UTF8_REPLACEMENT;
+    }
+
+    if (end - it < length) {
+        ++it;
+        return UTF8_REPLACEMENT;
+    }
+    for (int i = 1; i < length; i++) {
+        const unsigned char next = static_cast<unsigned char>(it[i]);
+        if ((next & 0xC0) != 0x80) {
+            ++it;
+            return UTF8_REPLACEMENT;
+        }
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+
+    // reject overlong encodings, surrogates and values past the last codepoint
+    if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        ++it;
+        return UTF8_REPLACEMENT;
+    }
+    it += length;
+    return codepoint;
+}
+
+#endif //GRAPHICS_UTF8_H
@@ -0,0 +1,134 @@
+// Compares two 8-bit RGB or RGBA PNG files per channel, for the golden image test (see cmake/compareFrame.cmake).
+// Usage: breakout_compare <actual.png> <expected.png> [tolerance] [max outlier fraction]
+// A pixel is an outlier if any channel differs by more than tolerance; the images match if at most the given
+// fraction of the pixels are outliers. The slack absorbs rounding differences between toolchains (SSE2 or
+// scalar code, FMA contraction, libm), not changes to what is drawn.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+namespace {
+    struct Image {
+        uint32_t width = 0, height = 0;
+        /// @brief width * height * 4 bytes, top row first
+        std::vector<unsigned char> rgba;
+    };
+
+    uint32_t readBigEndian(const unsigned char *bytes) {
+        return uint32_t(bytes[0]) << 24 | uint32_t(bytes[1]) << 16 | uint32_t(bytes[2]) << 8 | bytes[3];
+    }
+
+    int paeth(int a, int b, int c) {
+        const int p = a + b - c, pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+        return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+    }
+
+    /// @brief Decodes a non-interlaced PNG with 8 bits per channel, RGB or RGBA
+    bool readPng(const std::string &path, Image &image) {
+        std::ifstream in(path, std::ios::binary);
+        const std::vector<unsigned char> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        if (file.size() < 8 || !std::equal(signature, signature + 8, file.begin())) {
+            std::cout << "ERROR::COMPARE: " << path << " is not a PNG file" << std::endl;
+            return false;
+        }
+
+        int channels = 0;
+        std::vector<unsigned char> compressed;
+        for (size_t offset = 8; offset + 12 <= file.size();) {
+            const uint32_t length = readBigEndian(&file[offset]);
+            const std::string type(file.begin() + offset + 4, file.begin() + offset + 8);
+            const unsigned char *data = &file[offset + 8];
+            if (offset + 12 + length > file.size())
+                break;
+            if (type == "IHDR") {
+                image.width = readBigEndian(data);
+                image.height = readBigEndian(data + 4);
+                channels = data[9] == 6 ? 4 : data[9] == 2 ? 3 : 0;
+                if (data[8] != 8 || channels == 0 || data[12] != 0) {
+                    std::cout << "ERROR::COMPARE: " << path << " is not 8-bit RGB(A) without interlacing" << std::endl;
+                    return false;
+                }
+            } else if (type == "IDAT") {
+                compressed.insert(compressed.end(), data, data + length);
+            }
+            offset += 12 + length;
+        }
+
+        const size_t stride = size_t(image.width) * channels;
+        std::vector<unsigned char> raw((stride + 1) * image.height);
+        uLongf rawSize = static_cast<uLongf>(raw.size());
+        const int result = channels == 0 ? Z_DATA_ERROR
+                         : uncompress(raw.data(), &rawSize, compressed.data(), static_cast<uLong>(compressed.size()));
+        if (result != Z_OK || rawSize != raw.size()) {
+            std::cout << "ERROR::COMPARE: Failed to decompress " << path << std::endl;
+            return false;
+        }
+
+        // Undo the per row filters in place, then expand to RGBA
+        std::vector<unsigned char> pixels(stride * image.height);
+        for (uint32_t y = 0; y < image.height; ++y) {
+            const unsigned char filter = raw[y * (stride + 1)];
+            const unsigned char *source = &raw[y * (stride + 1) + 1];
+            unsigned char *row = &pixels[y * stride];
+            const unsigned char *above = y > 0 ? row - stride : nullptr;
+            for (size_t x = 0; x < stride; ++x) {
+                const int a = x >= size_t(channels) ? row[x - channels] : 0;
+                const int b = above ? above[x] : 0;
+                const int c = above && x >= size_t(channels) ? above[x - channels] : 0;
+                const int predictor = filter == 1 ? a : filter == 2 ? b : filter == 3 ? (a + b) / 2
+                                    : filter == 4 ? paeth(a, b, c) : 0;
+                row[x] = static_cast<unsigned char>(source[x] + predictor);
+            }
+        }
+        image.rgba.resize(size_t(image.width) * image.height * 4);
+        for (size_t i = 0; i < size_t(image.width) * image.height; ++i) {
+            for (int channel = 0; channel < 4; ++channel)
+                image.rgba[i * 4 + channel] = channel < channels ? pixels[i * channels + channel] : 255;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::cout << "Usage: " << argv[0] << " <actual.png> <expected.png> [tolerance] [max outlier fraction]"
+                  << std::endl;
+        return 2;
+    }
+    const int tolerance = argc > 3 ? std::atoi(argv[3]) : 4;
+    const double maxOutliers = argc > 4 ? std::atof(argv[4]) : 0.001;
+
+    Image actual, expected;
+    if (!readPng(argv[1], actual) || !readPng(argv[2], expected))
+        return 2;
+    if (actual.width != expected.width || actual.height != expected.height) {
+        std::cout << "Size differs: " << actual.width << "x" << actual.height << " instead of " << expected.width
+                  << "x" << expected.height << std::endl;
+        return 1;
+    }
+
+    size_t outliers = 0;
+    int largest = 0;
+    for (size_t i = 0; i < actual.rgba.size(); i += 4) {
+        int difference = 0;
+        for (int channel = 0; channel < 4; ++channel)
+            difference = std::max(difference, std::abs(actual.rgba[i + channel] - expected.rgba[i + channel]));
+        largest = std::max(largest, difference);
+        if (difference > tolerance)
+            outliers++;
+    }
+
+    const size_t pixelCount = size_t(actual.width) * actual.height;
+    std::cout << outliers << " of " << pixelCount << " pixels differ by more than " << tolerance
+              << " (largest difference " << largest << ")" << std::endl;
+    return outliers <= maxOutliers * pixelCount ? 0 : 1;
+}